@@ -15,7 +15,16 @@
 			Output a rectangular waveform for a number of repetitions.
 			
 		## Set chirp
-			Output a waveform with a frequency that changes linearly over time.
+			Output a waveform with phase widths that change linearly over time.
+			
+		## Set sweep
+			Output a waveform with phase widths that change either linearly or by a constant ratio over time (logarithmic sweep).
+			
+		## Set sequence
+			Play a table of segments (state and duration), with nested repeats, uploaded beforehand; trains then run without serial traffic.
+			
+		## Set port
+			Change the state of several pins of a port register in a single instruction.
 			
 		## Set PWM driver frequency (24 to 1024 Hz)
 			Instructs Adafruit's 16-Channel 12-bit PWM driver (PCA9685) to oscillate at the given frequency.
@@ -32,7 +41,7 @@
 			Listen to a pin for LOW or HIGH changes.
 		
 		## Get level
-			Listen to an analog pin for changes in the range 0 to 255.
+			Listen to an analog pin for changes in the range 0 to 1023.
 		
 		## Get rotation
 			Listen to changes in rotation produced by a rotary encoder in two pins.
@@ -78,6 +87,22 @@
 			
 				c <pin> <duration-low-start> <duration-low-stop> <duration-high-start> <duration-high-stop> <duration>
 				
+			### set-sweep
+			
+				x <pin> <shape> <duration-low-start> <duration-low-stop> <duration-high-start> <duration-high-stop> <duration>
+				Shape 0 is linear, as set-chirp; shape 1 is exponential and requires non-zero durations.
+				
+			### set-segment
+			
+				u <index> <kind> <value>
+				Write an entry of the sequence table, which then ends after it; entries are written from 0 onwards.
+				Kinds: 0 holds the pin low and 1 high for value us; 2 repeats the entries up to its matching 3 value times (0 is forever), nested up to 4 deep; 4 ends the sequence.
+				
+			### set-sequence
+			
+				U <pin> <start>
+				Play the sequence table on a pin from an entry.
+				
 			Zero repetitions means infinite
 				
 			### Set PWM driver frequency
@@ -88,6 +113,10 @@
 				
 				w <channel> <duration>
 			
+			### set-port
+			
+				P <port> <mask> <value>
+				
 			### stop-set
 			
 				s <pin>
@@ -100,13 +129,71 @@
 			
 				L <pin> <factor>
 				
+			### get-analog
+			
+				F <pin> <filter> <parameter> <deadband>
+				
+			Same as get-level, with samples filtered per pin and changes of up to deadband ignored. Filters: 0 none, 1 exponential with a time constant of 2^parameter samples (1 to 8), 2 moving average of 2^parameter samples (1 to 4), 3 median of parameter samples (3 or 5).
+				
+			### get-hysteresis
+			
+				H <pin> <low> <high> <filter> <parameter>
+				
+			Same as get-threshold, crossing upwards when the filtered value reaches high, and downwards when it drops below low.
+				
+			### get-comparator
+			
+				K <pin> <threshold> <reference> <debounce-rise> <debounce-fall>
+				
+			Same as get-threshold, with crossings detected by the analog comparator against reference 0 (internal 1.1V) or 1 (voltage on AIN0) when the pin reaches it (see Analog inputs below); threshold applies otherwise, and should match the reference (e.g. 225 for 1.1V with a 5V supply).
+				
 			### get-rotation
 			
 				R <active-pin> <passive-pin> <factor>
 				
+			### get-quadrature
+			
+				E <pin-a> <pin-b> <factor>
+				
+			### get-stream
+			
+				A <pin> <period>
+				
+			Sample an analog pin every period (100us to 32767us) and send the samples in blocks (see Analog inputs below). Stopped with stop-get.
+				
+			### get-errors
+			
+				e <pin>
+				
+			Number of edges the getter at the given pin detected as missed (illegal transitions of get-quadrature).
+				
 			### stop-get
 			
 				S <pin>
+				
+			### set-report
+			
+				r <flags>
+				
+			Flag bit 1 appends the time (us) at which the getter detected the event to each report. Flag bit 2 reports setters that finished (see done).
+			
+			### set-queue
+			
+				Q <flags>
+				
+			Flag bit 0 selects the coalesce policy and bit 1 adaptive report intervals (see Serial output below). Replies with the policy, the number of reports that did not fit in the queue per priority class, and the number of edges lost by the capture buffer.
+			
+			### set-interval
+			
+				I <pin> <interval>
+				
+			Minimum time (us) between reports of the getter at the given pin, or of all getters without an interval of their own when pin is 255.
+			
+			### get-time
+			
+				k
+				
+			Replies with the time (us) of the current Step, as sent in reports, and the time elapsed since startup, in seconds and microseconds.
 		
 		## Outputs (data sent from Arduino)
 			Data consists of two pin-value pairs (pin:\<pin\>,value:\<value\>); the first one is the pin number and the second is a value which varies in meaning according to the command assigned to that pin:
@@ -115,10 +202,22 @@
 				Number of times the pin was on low (negative number) or high (positive number).
 			
 			### get-level
-				Value of the analog pin.
+				Value of the analog pin, from 0 to 1023.
 			
 			### get-rotation
 				Positive or negative step of the rotation encoder.
+			
+			### get-stream
+				stream:{pin:<pin>,sequence:<sequence>,tic:<tic>,samples:[<sample>,...]}
+				Up to 8 consecutive samples (0 to 1023) of a block, and the time (us) of the first one. Blocks are numbered modulo 256; a skipped number is a block that was dropped.
+			
+			### refused
+				refused:{pin:<pin>}
+				A setter or getter requested for the pin could not be created because all of its kind are in use; it precedes the acknowledgment of the request.
+			
+			### done
+				done:{pin:<pin>}
+				The setter at the pin finished (e.g. set-pulse after its last repetition) and was removed. Sent when enabled with set-report.
 
 	# Raw mode
 		## Summary
@@ -184,6 +283,18 @@
 				|       24       | duration-high-stop              |
 				|       24       | duration                        |
 				
+			### set-sweep
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00001111               |
+				|       08       | pin                             |
+				|       08       | shape                           |
+				|       24       | duration-low-start              |
+				|       24       | duration-low-stop               |
+				|       24       | duration-high-start             |
+				|       24       | duration-high-stop              |
+				|       24       | duration                        |
+				
 			### set-PWM-driver-frequency
 				| Number of bits |           Description 
 				|:--------------:|:-------------------------------:|
@@ -197,6 +308,39 @@
 				|       04       | channel                         |
 				|       12       | fall-tic                        |
 				
+			### set-port
+				Write the bits selected by mask of a port register (e.g. PORTA is 1 ... PORTL is 12 in the Mega) at once. Setters and getters on affected pins are stopped.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00000110    |
+				|       08       | port                            |
+				|       08       | mask                            |
+				|       08       | value                           |
+				
+			### set-ports
+				Same as set-port for up to 20 ports, which are written one instruction apart. Commands with more ports are dropped.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00000111    |
+				|       08       | number of ports (n)             |
+				|     n * 24     | port, mask, value               |
+				
+			### set-segments
+				Write n entries of the sequence table (see set-segment) from an index; up to 15 per command. Commands with more entries are dropped.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00010000    |
+				|       08       | index                           |
+				|       08       | number of entries (n)           |
+				|     n * 32     | kind (8 bits), value (24 bits)  |
+				
+			### set-sequence
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00010001    |
+				|       08       | pin                             |
+				|       08       | start                           |
+				
 			### get-binary
 				| Number of bits |           Description 
 				|:--------------:|:-------------------------------:|
@@ -213,6 +357,38 @@
 				|       07       | pin                             |
 				|       07       | factor                          |
 				
+			### get-analog
+				Same as get-level, with filtered samples and a deadband (see get-analog in debug mode). Reported as get-level.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 11111000    |
+				|       08       | pin                             |
+				|       08       | filter                          |
+				|       08       | parameter                       |
+				|       16       | deadband                        |
+				
+			### get-hysteresis
+				Same as get-threshold, with thresholds low and high (0 to 1023) and filtered samples (see get-analog in debug mode). Reported as get-threshold.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 11110111    |
+				|       08       | pin                             |
+				|       16       | low                             |
+				|       16       | high                            |
+				|       08       | filter                          |
+				|       08       | parameter                       |
+				
+			### get-comparator
+				Same as get-threshold, with crossings detected by the analog comparator when the pin reaches it (see get-comparator in debug mode). Reported as get-threshold.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 11110110    |
+				|       08       | pin                             |
+				|       16       | threshold                       |
+				|       08       | reference                       |
+				|       24       | debounce-rise                   |
+				|       24       | debounce-fall                   |
+				
 			### get-rotation
 				| Number of bits |           Description 
 				|:--------------:|:-------------------------------:|
@@ -220,17 +396,181 @@
 				|       07       | active-pin                      |
 				|       07       | passive-pin                     |
 				|       07       | factor                          |
+				
+			### get-quadrature
+				Same as get-rotation but counting both edges of both pins (x4 resolution). Reported as get-rotation.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 11111010    |
+				|       08       | pin-a                           |
+				|       08       | pin-b                           |
+				|       08       | factor                          |
+				
+			### get-stream
+				Sample an analog pin every period (100us to 32767us), triggered by Timer1, and send the samples in blocks. Stopped with stop-get. Refused when Timer1 is in use (e.g. by set-pulse) or not available.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 11111001    |
+				|       08       | pin                             |
+				|       16       | period                          |
+				
+			### get-errors
+				Request the number of edges the getter at the given pin detected as missed (illegal transitions of get-quadrature).
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00001100    |
+				|       08       | pin                             |
 			
+			### set-report
+				Select the format of reports. Flags: bit 0 selects compact reports; bit 1 adds timestamps to compact reports; bit 2 reports setters that finished.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00001000    |
+				|       08       | flags                           |
+				
+			### set-queue
+				Select what happens to reports that do not fit in the transmit queue. Flags: bit 0 selects coalesce instead of drop, bit 1 enables adaptive report intervals (see Serial output below).
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00001001    |
+				|       08       | flags                           |
+				
+			### get-queue
+				Request the number of reports that did not fit in the transmit queue since startup, per priority class, the number of edges lost by the capture buffer, and in framed mode, the number of frames from the host missing from the sequence and dropped for a bad length or checksum.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00001010    |
+				
+			### set-interval
+				Minimum time (us) between reports of the getter at the given pin, or of all getters without an interval of their own when pin is 255. Reset when the getter is replaced.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00001011    |
+				|       08       | pin                             |
+				|       24       | interval                        |
+				
+			### get-time
+				Request the time (us) elapsed since startup, which does not wrap, unlike the 32-bit timestamps of reports.
+				| Number of bits |           Description 
+				|:--------------:|:-------------------------------:|
+				|       16       | entry-key: 11111111 00010010    |
+				
 		## Outputs (data sent from Arduino):
 			Data consist of 1 byte encoding the pin number and the direction of change using the pin*operand definition described above. When get-level is setup, several bytes will be sent to catch-up with the current value.
+			
+			With compact reports, each report is sent once regardless of its magnitude:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       08       | pin                             |
+				|       08       | kind: 0 binary, 1 contact, 2 level, 3 rotation, 4 threshold |
+				|    08 to 40    | value: zigzag-encoded varint, 7 bits per byte, least significant group first, bit 7 set on all but the last byte |
+			The value is the absolute level for get-level and the signed change for all other getters.
+			With timestamps, each compact report ends with a second zigzag-encoded varint: the time (us) at which the getter detected the event minus the time sent in the previous timestamped report (0 for the first report after set-report).
+			
+			Replies to get-queue start with 255, which never starts a report:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00001010               |
+				|       16       | overflows of the event class    |
+				|       16       | overflows of the bulk class     |
+				|       16       | edges lost by the capture buffer |
+				|       16       | frames missing from the sequence |
+				|       16       | frames dropped by the decoder   |
+			
+			Replies to get-errors:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00001100               |
+				|       08       | pin                             |
+				|       16       | count                           |
+			
+			Blocks of get-stream, with BRIDGE_STREAM_SIZE samples (32 by default) packed 4 per 5 bytes, most significant bit first:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 11111001               |
+				|       08       | pin                             |
+				|       08       | sequence, modulo 256; a gap indicates dropped blocks |
+				|       32       | time (us) of the first sample   |
+				|    10 * n      | samples                         |
+			
+			Replies to get-time:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00010010               |
+				|       64       | time (us) since startup, most significant byte first |
+			
+			Sent when a setter or getter requested for a pin could not be created because all of its kind are in use:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00001101               |
+				|       08       | pin                             |
+			
+			Sent when the setter at a pin finished and was removed, if enabled with set-report:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       16       | 11111111 00001110               |
+				|       08       | pin                             |
+		
+	# Framed mode
+		## Summary
+			Selected during the handshake by sending 'f' instead of 'r' (raw) or 'd' (debug). Commands and reports use the raw mode encoding, wrapped in frames that let either side detect corruption and loss, and recover at the next frame boundary:
+				| Number of bits |           Description           |
+				|:--------------:|:-------------------------------:|
+				|       08       | sync: 10100101                  |
+				|       08       | payload length (0 to 48)        |
+				|       08       | sequence number                 |
+				|     8 * n      | payload                         |
+				|       08       | CRC-8 (0x07) of length, sequence and payload |
+			
+			Each side increments the sequence number by one per frame sent; a gap indicates lost frames. Frames with a bad checksum are dropped and decoding resumes at the next sync byte. The device counts frames from the host that were missing or dropped (see get-queue).
+		
+		## Inputs (data sent to Arduino):
+			A frame contains one or more complete raw mode commands. Commands do not span frames.
+		
+		## Outputs (data sent from Arduino):
+			Queued reports are batched in frames as room in the serial transmit buffer allows. A report only spans frames when it is larger than a frame.
 		
 	# Considerations
 		## PWM Driver
 			- Driver uses D20 and D21 for communication. Grounding D21 may cause the device to freeze.
 		## Microcontroller
 			- board.cpp targets an Arduino Mega 2560; behavior implemented or assumed for _timer1_ and _interrupts_ may differ on other boards.
+		## Outputs
+			- Edges of set-pulse and set-chirp are written by the compare interrupt of a dedicated 16-bit timer (Timer5 on the Mega, Timer1 elsewhere; see EdgeScheduler.h) at their deadlines, with 0.5us resolution, regardless of serial and report load. Each edge is scheduled from the ideal time of the previous one, so phase errors do not accumulate.
+			- set-pulse on a pin wired to an output compare unit of Timer1, Timer3 or Timer4 (pins 2, 3, 5 to 8, 11 and 12 on the Mega, where pin 13 belongs to Timer0; see PulseGenerator.h) is generated by that timer instead, with no CPU cost per edge and clock-cycle accuracy, when its phases are exact multiples of a prescaler tick and its period fits 16 bits; finite trains need periods of at least 32us. Each timer serves one such pin at a time, and analogWrite is not available on its other pins meanwhile. Other pins and durations fall back to the scheduler.
+			- Up to BRIDGE_SCHEDULER_CHANNELS outputs are scheduled at once; further outputs, and phases of 0us or longer than about 17 minutes, are toggled from Step.
+			- Setters are kept in a min-heap by the time of their next step, so each Step only wakes those that are due; setters whose edges are written by the timer wake up once by their expected end. Setters that finished are removed, and their slots reused.
+			- set-sequence merges consecutive segments of the same state into phases of up to 32 segments, written by the scheduler; longer runs of a state continue without an edge, and the pin holds the state of the last phase. Up to BRIDGE_SEQUENCE_SIZE entries are stored (see SetSequence.h); uploading while a sequence plays alters it.
+			- analogWrite is not available on the pins of the scheduler timer (44 to 46 on the Mega, 9 and 10 on the Uno).
+		## Analog inputs
+			- get-level and get-threshold read the latest sample of their pin, taken in the background by the ADC: its conversion complete interrupt stores each result and starts a conversion of the next analog pin in use, in turns (see AnalogSampler.h). Each of n analog getters is sampled every n * 104us, and reading costs no conversion time in Step. analogRead must not be used meanwhile.
+			- Analog values have 10 bits. get-analog and get-hysteresis filter each new sample of their pin once, in fixed point (see AnalogFilter.h), and only report changes beyond the deadband or crossings of the hysteresis thresholds, so that reports follow the signal rather than ADC noise. Compact reports (see set-report) suit get-level best, since raw reports repeat a byte per unit of change.
+			- get-comparator is served by the analog comparator interrupt on AIN1 (pin 5 on the Mega, 7 on the Uno; see AnalogComparator.h), or on an analog pin through the ADC multiplexer while no other analog getter or stream uses the ADC, which is then off; an analog getter or stream added later takes the ADC back, and the pin is then sampled against threshold. Crossings are queued with their time (us) by the interrupt service routine, as edges of get-binary, hence idle inputs cost no CPU time and short excursions are not missed; debounce applies as with get-threshold. The comparator has no hysteresis. One pin is served at a time; other pins are sampled by the ADC against threshold.
+			- get-stream takes over the ADC, with conversions triggered by Timer1 at a fixed rate (up to 10 kHz), so samples are evenly spaced. One pin is streamed at a time, and get-level and get-threshold hold their last value meanwhile. Samples are collected in two blocks in turns: a full block is sent while the other one fills; a block that fills up before the previous one is queued is dropped. The serial link must carry 10 bits per sample plus 8 bytes per block (e.g. 12.5 kB/s at 10 kHz).
+		## Routines
+			- Setters and getters are constructed in fixed pools sized per board (see Pools.h) and their slots are reused once stopped or replaced, so the heap is never used after startup.
+			- Up to BRIDGE_SETTERS setters and BRIDGE_GETTERS getters run at once. Requests beyond either limit, or beyond the pool of their kind, are refused (see refused).
+		## Serial input
+			- Commands are assembled across calls to Step and executed once all of their bytes arrived; a partial command never blocks the loop.
+			- A raw command longer than BRIDGE_CHANNEL_SIZE bytes is dropped along with the rest of the bytes it declares, so they are not read as further commands. In debug mode, an overlong command returns to waiting for a handshake.
+			- At most readBytes bytes and readDuration microseconds are spent reading serial per Step (see SetReadBudget).
+		## Interrupts
+			- Edges of get-binary and get-rotation pins are queued with their time (us) by an interrupt service routine, and handed to the getters at the next Step; debounce and timestamps use that time.
+			- Pins with an external interrupt use it; other pins use their pin change interrupt (PCINT), if any, for up to BRIDGE_PIN_CHANGES pins. Pins sharing a pin change bank must belong to the same port.
+			- Remaining pins, up to BRIDGE_POLLED across BRIDGE_POLL_PORTS ports, are polled: each Step reads every port in use once, compares it with the previous snapshot, and only hands changed pins to their getters, timed at that Step.
+			- get-rotation samples the passive pin in the interrupt service routine, so the direction matches the time of the edge.
+			- get-quadrature decodes both pins in the interrupt service routine with a transition table when both pins have an interrupt (external or pin change), and when a polled pin changes otherwise. Its reports are timed at the Step that sees the change.
+			- Up to BRIDGE_EDGES_SIZE edges are buffered between steps; further edges are lost and counted (see get-queue).
+		## Serial output
+			- Reports and replies are queued and moved into the serial transmit buffer only as far as it has room, hence Step never waits on serial.
+			- The queue has two priority classes of BRIDGE_QUEUE_SIZE bytes each: events (get-binary, get-contact, get-threshold, replies) are sent ahead of streams (get-level, get-rotation). A report is never interleaved with another.
+			- A report that does not fit is dropped (default) or, with the coalesce policy, kept by its getter and merged into its next report; either way it is counted as an overflow of its class. Raw reports, which the host sums, are never dropped: runs of more than BRIDGE_QUEUE_SIZE - 1 units span several records, and the units that do not fit stay with the getter until there is room.
+			- With a report interval (see set-interval), a getter reports at most once per interval: get-binary, get-level and get-rotation send one report summarizing the interval, get-contact and get-threshold send their transitions in order. The first change after a quiet interval is sent right away.
+			- With adaptive intervals, report intervals double for each quarter of the fuller priority class in use. When neither the getter nor the global interval is set, the doubling starts from BRIDGE_ADAPTIVE_INTERVAL (1 ms) once a quarter of the queue is in use.
 		## Development
+			- Time is sampled from micros() once per Step as a 32-bit tic, which wraps every 71.6 minutes; deadlines and debounce compare tics relative to each other, so they hold across the wrap for waits under 35.8 minutes. Longer waits are taken in several steps, and timestamps in reports keep 32 bits (see Timebase.h). A 64-bit time since startup is extended from consecutive tics (see get-time).
 			- Most C++ libraries are not available in embedded systems like the Arduino, consequently _vector_ and _iostream_ could not be used.
+			- Interrupt service routines of the library (pin change, scheduler, pulse generator, ADC and analog comparator) are defined here, by expanding their BRIDGE_*_VECTORS macros; other sketches using the library keep those vectors for other libraries (e.g. SoftwareSerial or Servo), and fall back to polling.
 			- SRAM available is 8KBs.
 		## Debugging
 			- Serial communication interferes with timer events, hence pulse width modulation is coarse in debug mode where bandwidth use is high.
@@ -244,43 +584,81 @@
 */
 
 #include "Arduino.h"
-#include "WString.h"
 #include "HardwareSerial.h"
 #include "Adafruit_PWMServoDriver.h"
+#include "AnalogComparator.h"
+#include "AnalogSampler.h"
+#include "EdgeScheduler.h"
+#include "PulseGenerator.h"
 
 #include "Bridge.h"
 #include "Channel.h"
+#include "Frame.h"
 #include "GetBinary.h"
 #include "GetRotation.h"
 #include "GetContact.h"
 #include "GetLevel.h"
 #include "GetThreshold.h"
-#include "LinkedIndex.h"
+#include "Pools.h"
+#include "Queue.h"
 #include "SetBinary.h"
 #include "SetChirp.h"
 #include "SetPulse.h"
+#include "SetSequence.h"
+#include "PinChange.h"
+#include "Text.h"
+#include "Timebase.h"
+#include "tools.h"
 
-#include "meta.h"
 #include "types.h"
 
 using PWMDriver = Adafruit_PWMServoDriver;
 namespace bridge {
-	LinkedIndex<Routine*> Bridge::setters(nHid);
-	LinkedIndex<Routine*> Bridge::getters(nHid);
+	Bridge::Setters Bridge::setters;
+	DeadlineHeap<BRIDGE_SETTERS, Bridge::nHid> Bridge::deadlines;
+	Bridge::Getters Bridge::getters;
 	Bridge* Bridge::instance;
 	HardwareSerial* Bridge::serial;
 	Bridge::Status Bridge::status;
 	ReportFunction Bridge::reportFunction;
+	uint32_t Bridge::reportInterval = 0;
+	bool Bridge::adaptive = false;
+	bool Bridge::reported = false;
+	bool Bridge::timestamps = false;
+	bool Bridge::completions = false;
+	uint8_t Bridge::streamPin = 255;
+	uint16_t Bridge::streamPeriod = 0;
+	uint32_t Bridge::reportTic = 0;
 	uint32_t Bridge::baudrate;
+	Bridge::Edges Bridge::edges;
+	uint8_t Bridge::sourcePins[nSources];
+	uint8_t Bridge::sourceTriggers[nSources];
+	volatile uint8_t* Bridge::samplePorts[nSources];
+	uint8_t Bridge::sampleMasks[nSources];
+	bool Bridge::risings[nSources];
+	Quadrature* Bridge::decoders[nSources];
+	volatile uint8_t* Bridge::pollPorts[nPollPorts];
+	uint8_t Bridge::pollMasks[nPollPorts];
+	uint8_t Bridge::pollStates[nPollPorts];
+	uint8_t Bridge::pollSources[nPollPorts][8];
+	Queue Bridge::queue;
+	Frame Bridge::txFrame;
+	uint8_t Bridge::txSequence = 0;
+	uint8_t Bridge::txLength = 0;
+	uint8_t Bridge::txOffset = 0;
+	uint8_t Bridge::rxSequence = 0;
+	uint16_t Bridge::rxLost = 0;
+	uint8_t Bridge::readBytes = 64;
+	uint32_t Bridge::readDuration = 500;
 	uint8_t Bridge::tonePin;
 	PWMDriver Bridge::pwmDriver = PWMDriver();
 
-	static volatile uint64_t tic = 0;
+	static uint32_t tic = 0;
 	
 	Bridge::Bridge() {
 	}
 	
-	Bridge::Bridge(HardwareSerial* serial, uint32_t baudrate) : pwmSetup(true) {
+	Bridge::Bridge(HardwareSerial* serial, uint32_t baudrate) : pwmSetup(true), rxSynced(false), discard(0) {
 		Bridge::instance = this;
 		Bridge::serial = serial;
 		Bridge::baudrate = baudrate;
@@ -289,9 +667,12 @@ namespace bridge {
 		
 		Bridge::tonePin = 13;
 		
+		for (uint8_t id = 0; id < nSources; id++)
+			sourcePins[id] = 255;
+		
 		// Start communication.
 		serial->begin(baudrate);
-		channel = Channel(serial);
+		channel = Channel();
 		handshake();
 		serial->flush();
 		// All data received by serialEvent up to this point was discarded.
@@ -305,17 +686,26 @@ namespace bridge {
 	
 	void Bridge::Step() {
 		//Serial.println("x");
-		tic = micros();
+		tic = Timebase::update();
 		
 		// Read serial and report state of getters.
 		instance->read();
 		setterRoutine();
+		drain();
+		poll();
 		getterRoutine();
+		stream();
 		// Report state of getters.
-		Routine* routine;
-		getters.begin();
-		while (getters.next(routine))
-			routine->report(reportFunction);
+		for (uint8_t index = 0; index < getters.size(); index++) {
+			Routine* routine = getters.at(index);
+			if (due(routine)) {
+				reported = false;
+				getters.report(index, reportFunction);
+				if (reported)
+					routine->reportTic = tic;
+			}
+		}
+		flush();
 	}
 	
 	void Bridge::handshake() {
@@ -324,278 +714,778 @@ namespace bridge {
 		serial->write(255);
 	}
 	
+	// Limit the time spent parsing commands so that setters and getters are not starved.
+	void Bridge::SetReadBudget(uint8_t nbytes, uint32_t duration) {
+		readBytes = max(nbytes, 1);
+		readDuration = duration;
+	}
+	
+	// Move available bytes into the pending command and execute it once complete. Incomplete commands are kept between steps.
 	void Bridge::read() {
-		while (serial->available()) {
-			if (status == Status::debug) {
-				char header = channel.read();
-				if (header == 'a') {
-					// Change microcontroller's address.
-					uint8_t address = channel.parse(255);
-					uint8_t value   = channel.parse(255);
-					serial->print(String() + "set-address:{address:" + (int) address + ",value:" + (int) value + "}\n");
-					*reinterpret_cast<volatile uint8_t*>(address) = value;
-				} else if (header == 'b') {
-					// Set state of the pin to a fixed value.
-					uint8_t hid   = channel.parse(nHid);
-					uint8_t state = channel.parse( 1);
+		uint32_t start = micros();
+		uint8_t nbytes = 0;
+		while (serial->available() && nbytes < readBytes && micros() - start < readDuration) {
+			nbytes++;
+			uint8_t byte = serial->read();
+			if (status == Status::framed) {
+				bool ready = rxFrame.push(byte);
+				while (ready) {
+					// Count frames missing from the sequence.
+					if (rxSynced)
+						rxLost += (uint8_t) (rxFrame.sequence() - rxSequence - 1);
+					rxSynced = true;
+					rxSequence = rxFrame.sequence();
+					// Commands do not span frames.
+					channel.clear();
+					for (uint8_t i = 0; i < rxFrame.size(); i++)
+						consume(rxFrame.at(i));
+					channel.clear();
+					discard = 0;
+					// Bytes kept after a resync may already hold the next frame.
+					ready = rxFrame.next();
+				}
+			} else {
+				consume(byte);
+			}
+		}
+	}
+	
+	// Append a byte to the pending command and execute it once complete.
+	void Bridge::consume(uint8_t byte) {
+		if (discard > 0) {
+			// Remainder of a dropped command.
+			discard--;
+		} else if (!channel.push(byte)) {
+			// Command does not fit; drop it.
+			drop(channel.size() + 1);
+		} else if (!supported()) {
+			// Command declares more entries than can be executed.
+			drop(channel.size());
+		} else if (complete()) {
+			execute();
+			channel.clear();
+		}
+	}
+	
+	// Drop the pending command, of which nreceived bytes arrived, so that the rest of it is not parsed as further commands.
+	void Bridge::drop(uint8_t nreceived) {
+		if (status == Status::debug) {
+			// Text commands have no declared length; wait for a new handshake.
+			status = Status::handshake;
+		} else {
+			uint16_t length = declared();
+			discard = length > nreceived ? length - nreceived : 0;
+		}
+		channel.clear();
+	}
+	
+	// Whether the pending command has all of its bytes.
+	bool Bridge::complete() {
+		uint8_t size = channel.size();
+		if (status == Status::debug) {
+			// Number of numeric parameters expected after each header.
+			uint8_t nparams;
+			switch (channel.at(0)) {
+				case 'q': case 's': case 'S': case 'e':
+					nparams = 1;
+					break;
+				case 'a': case 'b': case 'w': case 'I':
+					nparams = 2;
+					break;
+				case 'r': case 'Q':
+					nparams = 1;
+					break;
+				case 't': case 'L': case 'R': case 'E': case 'P':
+					nparams = 3;
+					break;
+				case 'B': case 'T': case 'F':
+					nparams = 4;
+					break;
+				case 'p': case 'H': case 'K':
+					nparams = 5;
+					break;
+				case 'c': case 'C':
+					nparams = 6;
+					break;
+				case 'x':
+					nparams = 7;
+					break;
+				case 'u':
+					nparams = 3;
+					break;
+				case 'U': case 'A':
+					nparams = 2;
+					break;
+				case 'k':
+					nparams = 0;
+					break;
+				default:
+					nparams = 0;
+			}
+			// Count parameters as parsed by Channel::parse: 'm' or digits followed by one trailing character.
+			uint8_t i = 1;
+			uint8_t n = 0;
+			while (n < nparams) {
+				while (i < size && channel.at(i) != 'm' && (channel.at(i) < '0' || channel.at(i) > '9'))
+					i++;
+				if (i == size)
+					return false;
+				if (channel.at(i) == 'm') {
+					i++;
+				} else {
+					while (i < size && channel.at(i) >= '0' && channel.at(i) <= '9')
+						i++;
+					if (i == size)
+						return false;
+					i++;
+				}
+				n++;
+			}
+			return true;
+		} else if (status == Status::raw || status == Status::framed) {
+			uint16_t length = declared();
+			return length > 0 && size == length;
+		} else {
+			return size > 0;
+		}
+	}
+	
+	// Whether the counts declared by the pending raw command are within limits; true until they arrived.
+	bool Bridge::supported() {
+		if (status != Status::raw && status != Status::framed)
+			return true;
+		if (channel.size() < 3 || channel.at(0) != 255)
+			return true;
+		switch (channel.at(1)) {
+			case 7: return channel.at(2) <= nPorts;	// set-ports.
+			case 16: return channel.size() < 4 || channel.at(3) <= nSegments;	// set-segments.
+			default: return true;
+		}
+	}
+	
+	// Number of bytes of the pending raw command, key included; 0 until the bytes that tell it arrived.
+	uint16_t Bridge::declared() {
+		uint8_t size = channel.size();
+		uint8_t key = channel.at(0);
+		if (size == 0) {
+			return 0;
+		} else if (key < 254) {
+			return 1;
+		} else if (key == 254) {
+			return 3;
+		} else if (size < 2) {
+			return 0;
+		} else {
+			// Payload length in bytes after the two-byte key.
+			uint16_t length;
+			switch (channel.at(1)) {
+				case   0: length =  1; break;	// stop.
+				case   1: length = 10; break;	// set-pulse.
+				case   2: length = 16; break;	// set-chirp.
+				case   3: length =  2; break;	// set-pwm frequency.
+				case   4: length =  2; break;	// set-pwm value.
+				case   5: length =  6; break;	// set-tone.
+				case   6: length =  3; break;	// set-port.
+				case   7:						// set-ports.
+					if (size < 3)
+						return 0;
+					length = 1 + 3 * (uint16_t) channel.at(2);
+					break;
+				case   8: length =  1; break;	// set-report.
+				case   9: length =  1; break;	// set-queue.
+				case  10: length =  0; break;	// get-queue.
+				case  11: length =  4; break;	// set-interval.
+				case  12: length =  1; break;	// get-errors.
+				case  15: length = 17; break;	// set-sweep.
+				case  16:						// set-segments.
+					if (size < 4)
+						return 0;
+					length = 2 + 4 * (uint16_t) channel.at(3);
+					break;
+				case  17: length =  2; break;	// set-sequence.
+				case  18: length =  0; break;	// get-time.
+				case 255: length =  8; break;	// get-binary.
+				case 254: length = 10; break;	// get-contact.
+				case 253: length =  7; break;	// get-level.
+				case 252: length =  3; break;	// get-rotation.
+				case 251: length =  8; break;	// get-threshold.
+				case 250: length =  3; break;	// get-quadrature.
+				case 249: length =  3; break;	// get-stream.
+				case 248: length =  5; break;	// get-analog.
+				case 247: length =  7; break;	// get-hysteresis.
+				case 246: length = 10; break;	// get-comparator.
+				default:  length =  0;
+			}
+			return 2 + length;
+		}
+	}
+	
+	// Execute the pending command.
+	void Bridge::execute() {
+		if (status == Status::debug) {
+			char header = channel.read();
+			if (header == 'a') {
+				// Change microcontroller's address.
+				uint8_t address = channel.parse(255);
+				uint8_t value   = channel.parse(255);
+				Text(&queue) << F("set-address:{address:") << (int) address << F(",value:") << (int) value << F("}\n");
+				*reinterpret_cast<volatile uint8_t*>(address) = value;
+			} else if (header == 'b') {
+				// Set state of the pin to a fixed value.
+				uint8_t hid   = channel.parse(nHid);
+				uint8_t state = channel.parse( 1);
+				removeSetter(hid);
+				SetBinary(hid, state);
+				Text(&queue) << F("set-binary:{pin:") << hid << F(",state:") << state << F("}\n");
+			} else if (header == 'p') {
+				uint8_t hid           = channel.parse(nHid);
+				bool stateStart       = channel.parse( 1);
+				uint32_t durationLow  = channel.parse(-1);
+				uint32_t durationHigh = channel.parse(-1);
+				uint32_t repetitions  = channel.parse(-1);
+				removeSetter(hid);
+				addSetter(hid, Pools::setPulse.create(hid, stateStart, durationLow, durationHigh, repetitions));
+				Text text(&queue);
+				text << F("set-pulse:{pin:") << hid << F(",state-start:") << stateStart << F(",duration-low:") << durationLow << F(",duration-high:") << durationHigh << F(",repetitions:");
+				if (repetitions == 0)
+					text << F("infinite");
+				else
+					text << repetitions;
+				text << F("}\n");
+			} else if (header == 'c') {
+				uint8_t hid                = channel.parse(nHid);
+				uint32_t durationLowStart  = channel.parse(-1);
+				uint32_t durationLowStop   = channel.parse(-1);
+				uint32_t durationHighStart = channel.parse(-1);
+				uint32_t durationHighStop  = channel.parse(-1);
+				uint32_t duration          = channel.parse(-1);
+				removeSetter(hid);
+				addSetter(hid, Pools::setChirp.create(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration));
+				Text(&queue) << F("set-chirp:{pin:") << hid << F(",duration-low-start:") << durationLowStart << F(",duration-low-stop:") << durationLowStop << F(",duration-high-start:") << durationHighStart << F(",duration-high-stop:") << durationHighStop << F(",duration:") << duration << F("}\n");
+			} else if (header == 'x') {
+				uint8_t hid                = channel.parse(nHid);
+				uint8_t shape              = channel.parse(1);
+				uint32_t durationLowStart  = channel.parse(-1);
+				uint32_t durationLowStop   = channel.parse(-1);
+				uint32_t durationHighStart = channel.parse(-1);
+				uint32_t durationHighStop  = channel.parse(-1);
+				uint32_t duration          = channel.parse(-1);
+				removeSetter(hid);
+				addSetter(hid, Pools::setChirp.create(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration, (Chirp::Shape) shape));
+				Text(&queue) << F("set-sweep:{pin:") << hid << F(",shape:") << (shape ? F("exponential") : F("linear")) << F(",duration-low-start:") << durationLowStart << F(",duration-low-stop:") << durationLowStop << F(",duration-high-start:") << durationHighStart << F(",duration-high-stop:") << durationHighStop << F(",duration:") << duration << F("}\n");
+			} else if (header == 'q') {
+				uint32_t frequency = channel.parse(-1);
+				frequency = max(frequency, 24);
+				SetupPWM();
+				pwmDriver.setPWMFreq(frequency);
+				Text(&queue) << F("set-driver-frequency:{frequency:") << frequency << F("}\n");
+			} else if (header == 'w') {
+				uint8_t hid       = channel.parse(16);
+				uint16_t duration = channel.parse(-1);
+				SetPWM(hid, duration);
+				Text(&queue) << F("set-driver-duration:{channel:") << hid << F(",duration:") << duration << F("}\n");
+			} else if (header == 'u') {
+				uint8_t index  = channel.parse(255);
+				uint8_t kind   = channel.parse(255);
+				uint32_t value = channel.parse(-1);
+				SetSequence::load(index, kind, value);
+				Text(&queue) << F("set-segment:{index:") << index << F(",kind:") << kind << F(",value:") << value << F(",size:") << SetSequence::size() << F("}\n");
+			} else if (header == 'U') {
+				uint8_t hid   = channel.parse(nHid);
+				uint8_t start = channel.parse(255);
+				removeSetter(hid);
+				addSetter(hid, Pools::setSequence.create(hid, start));
+				Text(&queue) << F("set-sequence:{pin:") << hid << F(",start:") << start << F("}\n");
+			} else if (header == 'P') {
+				uint8_t port  = channel.parse(255);
+				uint8_t mask  = channel.parse(255);
+				uint8_t value = channel.parse(255);
+				writePorts(1, &port, &mask, &value);
+				Text(&queue) << F("set-port:{port:") << port << F(",mask:") << mask << F(",value:") << value << F("}\n");
+			} else if (header == 'r') {
+				uint8_t flags = channel.parse(255);
+				setReport(flags);
+				Text(&queue) << F("set-report:{timestamps:") << timestamps << F(",completions:") << completions << F("}\n");
+			} else if (header == 'Q') {
+				setQueue(channel.parse(255));
+				Text(&queue) << F("queue:{coalesce:") << (queue.policy == Queue::Policy::coalesce) << F(",overflow-event:") << queue.overflows[0] << F(",overflow-bulk:") << queue.overflows[1] << F(",overflow-edges:") << edges.GetOverflows() << F("}\n");
+			} else if (header == 'I') {
+				uint8_t hid = channel.parse(255);
+				uint32_t interval = channel.parse(-1);
+				setInterval(hid, interval);
+				Text(&queue) << F("set-interval:{pin:") << hid << F(",interval:") << interval << F("}\n");
+			} else if (header == 's') {
+				uint8_t hid = channel.parse(nHid);
+				removeSetter(hid);
+				Text(&queue) << F("stop-set:{pin:") << hid << F("}\n");
+			} else if (header == 't') {
+				uint8_t hid        = channel.parse(nHid);
+				uint32_t frequency = channel.parse(-1);
+				uint32_t duration  = channel.parse(-1);
+				noTone(tonePin);
+				tonePin = hid;
+				uint32_t durationMs = round(0.001L * duration);
+				if (frequency > 0 && durationMs > 0)
+					tone(hid, frequency, durationMs);
+				Text(&queue) << F("set-tone:{pin:") << hid << F(",frequency:") << frequency << F(",duration:") << duration << F("}\n");
+			} else if (header == 'B') {
+				uint8_t hid           = channel.parse(nHid);
+				uint32_t debounceRise = channel.parse(-1);
+				uint32_t debounceFall = channel.parse(-1);
+				uint8_t factor        = channel.parse(255);
+				removeGetter(hid);
+				if (addGetter(hid, Pools::getBinary.create(hid, debounceRise, debounceFall, max(factor, 1))))
+					attachEdges(hid, hid, CHANGE);
+				Text(&queue) << F("get-binary:{pin:") << hid << F(",debounce-rise:") << debounceRise << F(",debounce-fall:") << debounceFall << F(",factor:") << factor << F("}\n");
+			} else if (header == 'C') {
+				uint8_t hid0          = channel.parse(nHid);
+				uint8_t hid1          = channel.parse(nHid);
+				uint8_t samples       = channel.parse(255);
+				uint8_t snr           = channel.parse(255);
+				uint32_t debounceRise = channel.parse(-1);
+				uint32_t debounceFall = channel.parse(-1);
+				removeGetter(hid0);
+				removeGetter(hid1);
+				addGetter(hid0, Pools::getContact.create(hid0, hid1, samples, snr, debounceRise, debounceFall));
+				Text(&queue) << F("get-contact:{pins:[") << hid0 << ',' << hid1 << F("],samples:") << samples << F(",SNR:") << snr << F(",debounce-rise:") << debounceRise << F(",debounce-fall:") << debounceFall << F("}\n");
+			} else if (header == 'L') {
+				uint8_t hid           = channel.parse(nHid);
+				uint32_t debounceRise = channel.parse(-1);
+				uint32_t debounceFall = channel.parse(-1);
+				removeGetter(hid);
+				reclaimAdc();
+				addGetter(hid, Pools::getLevel.create(hid, debounceRise, debounceFall));
+				Text(&queue) << F("get-level:{pin:") << hid << F(",debounce-rise:") << debounceRise << F(",debounce-fall:") << debounceFall << F("}\n");
+			} else if (header == 'R') {
+				uint8_t hid0   = channel.parse(nHid);
+				uint8_t hid1   = channel.parse(nHid);
+				uint8_t factor = channel.parse(255);
+				removeGetter(hid0);
+				removeGetter(hid1);
+				if (addGetter(hid0, Pools::getRotation.create(hid0, hid1, max(factor, 1))))
+					attachEdges(hid0, hid1, RISING);
+				Text(&queue) << F("get-rotation:{pins:[") << hid0 << ',' << hid1 << F("],factor:") << factor << F("}\n");
+			} else if (header == 'E') {
+				uint8_t hid0   = channel.parse(nHid);
+				uint8_t hid1   = channel.parse(nHid);
+				uint8_t factor = channel.parse(255);
+				removeGetter(hid0);
+				removeGetter(hid1);
+				GetRotation* getter = Pools::getRotation.create(hid0, hid1, max(factor, 1), true);
+				if (addGetter(hid0, getter))
+					attachDecoder(hid0, hid1, getter->quadrature());
+				Text(&queue) << F("get-quadrature:{pins:[") << hid0 << ',' << hid1 << F("],factor:") << factor << F("}\n");
+			} else if (header == 'A') {
+				uint8_t hid     = channel.parse(nHid);
+				uint16_t period = channel.parse(0xFFFF);
+				addStream(hid, period);
+				Text(&queue) << F("get-stream:{pin:") << hid << F(",period:") << period << F("}\n");
+			} else if (header == 'e') {
+				uint8_t hid = channel.parse(nHid);
+				uint8_t index;
+				uint16_t count = getters.find(hid, index) ? getters.errors(index) : 0;
+				Text(&queue) << F("errors:{pin:") << hid << F(",count:") << count << F("}\n");
+			} else if (header == 'k') {
+				uint64_t epoch = Timebase::epoch();
+				Text(&queue) << F("time:{tic:") << tic << F(",seconds:") << (uint32_t) (epoch / 1000000) << F(",micros:") << (uint32_t) (epoch % 1000000) << F("}\n");
+			} else if (header == 'S') {
+				uint8_t hid = channel.parse(nHid);
+				removeGetter(hid);
+				Text(&queue) << F("stop-get:{pin:") << hid << F("}\n");
+			} else if (header == 'T') {
+				uint8_t hid           = channel.parse(nHid);
+				uint8_t threshold     = channel.parse(255);
+				uint32_t debounceRise = channel.parse(-1);
+				uint32_t debounceFall = channel.parse(-1);
+				removeGetter(hid);
+				reclaimAdc();
+				addGetter(hid, Pools::getThreshold.create(hid, threshold, threshold, debounceRise, debounceFall));
+				Text(&queue) << F("get-threshold:{pin:") << hid << F(",threshold:") << threshold << F(",debounce-rise:") << debounceRise << F(",debounce-fall:") << debounceFall << F("}\n");
+			} else if (header == 'F') {
+				uint8_t hid       = channel.parse(nHid);
+				uint8_t filter    = channel.parse(255);
+				uint8_t parameter = channel.parse(255);
+				uint16_t deadband = channel.parse(1023);
+				removeGetter(hid);
+				reclaimAdc();
+				addGetter(hid, Pools::getLevel.create(hid, 0, 0, (AnalogFilter::Type) filter, parameter, deadband));
+				Text(&queue) << F("get-analog:{pin:") << hid << F(",filter:") << filter << F(",parameter:") << parameter << F(",deadband:") << deadband << F("}\n");
+			} else if (header == 'H') {
+				uint8_t hid       = channel.parse(nHid);
+				uint16_t low      = channel.parse(1023);
+				uint16_t high     = channel.parse(1023);
+				uint8_t filter    = channel.parse(255);
+				uint8_t parameter = channel.parse(255);
+				removeGetter(hid);
+				reclaimAdc();
+				addGetter(hid, Pools::getThreshold.create(hid, low, high, 0, 0, (AnalogFilter::Type) filter, parameter));
+				Text(&queue) << F("get-hysteresis:{pin:") << hid << F(",low:") << low << F(",high:") << high << F(",filter:") << filter << F(",parameter:") << parameter << F("}\n");
+			} else if (header == 'K') {
+				uint8_t hid           = channel.parse(nHid);
+				uint16_t threshold    = channel.parse(1023);
+				uint8_t reference     = channel.parse(1);
+				uint32_t debounceRise = channel.parse(-1);
+				uint32_t debounceFall = channel.parse(-1);
+				removeGetter(hid);
+				if (addGetter(hid, Pools::getThreshold.create(hid, threshold, threshold, debounceRise, debounceFall, AnalogFilter::Type::None, 0, false)))
+					attachComparator(hid, (AnalogComparator::Reference) reference);
+				Text(&queue) << F("get-comparator:{pin:") << hid << F(",threshold:") << threshold << F(",reference:") << reference << F(",debounce-rise:") << debounceRise << F(",debounce-fall:") << debounceFall << F("}\n");
+			}
+		} else if (status == Status::raw || status == Status::framed) {
+			uint8_t key = channel.read();
+			if (key < 254) {
+				// set-binary.
+				uint8_t hid;
+				bool state;
+				if (decodeState(key, hid, state)) {
 					removeSetter(hid);
 					SetBinary(hid, state);
-					serial->print(String() + "set-binary:{pin:" + hid + ",state:" + state + "}\n");
-				} else if (header == 'p') {
-					uint8_t hid           = channel.parse(nHid);
-					bool stateStart       = channel.parse( 1);
-					uint32_t durationLow  = channel.parse(-1);
-					uint32_t durationHigh = channel.parse(-1);
-					uint32_t repetitions  = channel.parse(-1);
+				}
+			} else if (key == 254) {
+				// set-address.
+				uint8_t address = channel.read();
+				uint8_t value = channel.read();
+				*reinterpret_cast<volatile uint8_t*>(address) = value;
+			} else if (key == 255) {
+				// Key continues with 1 more byte.
+				key = channel.read();
+				// Reset bit carret.
+				channel.next();
+				if (key == 0) {
+					// stop.
+					uint8_t hid = channel.next( 7);
+					bool choice	= channel.next( 1);
+					if (choice)
+						removeGetter(hid);
+					else
+						removeSetter(hid);
+				} else if (key == 1) {
+					// set-pulse.
+					uint8_t hid           = channel.next( 7);
+					bool stateStart       = channel.next( 1);
+					uint64_t durationLow  = channel.next(24);
+					uint64_t durationHigh = channel.next(24);
+					uint64_t repetitions  = channel.next(24);
 					removeSetter(hid);
-					setters.set(hid, new SetPulse(hid, stateStart, durationLow, durationHigh, repetitions));
-					serial->print(String() + "set-pulse:{pin:" + hid + ",state-start:" + stateStart + ",duration-low:" + durationLow + ",duration-high:" + durationHigh + ",repetitions:" + ((repetitions == 0) ? "infinite" : String() + repetitions) + "}\n");
-				} else if (header == 'c') {
-					uint8_t hid                = channel.parse(nHid);
-					uint32_t durationLowStart  = channel.parse(-1);
-					uint32_t durationLowStop   = channel.parse(-1);
-					uint32_t durationHighStart = channel.parse(-1);
-					uint32_t durationHighStop  = channel.parse(-1);
-					uint32_t duration          = channel.parse(-1);
+					addSetter(hid, Pools::setPulse.create(hid, stateStart, durationLow, durationHigh, repetitions));
+				} else if (key == 2) {
+					// set-chirp.
+					uint8_t hid                = channel.next( 8);
+					uint64_t durationLowStart  = channel.next(24);
+					uint64_t durationLowStop   = channel.next(24);
+					uint64_t durationHighStart = channel.next(24);
+					uint64_t durationHighStop  = channel.next(24);
+					uint64_t duration          = channel.next(24);
 					removeSetter(hid);
-					setters.set(hid, new SetChirp(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration));
-					serial->print(String() + "set-chirp:{pin:" + hid + ",duration-low-start:" + durationLowStart + ",duration-low-stop:" + durationLowStop + ",duration-high-start:" + durationHighStart + ",duration-high-stop:" + durationHighStop + ",duration:" + duration + "}\n");
-				} else if (header == 'q') {
-					uint32_t frequency = channel.parse(-1);
+					addSetter(hid, Pools::setChirp.create(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration));
+				} else if (key == 3) {
+					uint16_t frequency = channel.next(16);
+					// set-pwm frequency.
 					frequency = max(frequency, 24);
 					SetupPWM();
 					pwmDriver.setPWMFreq(frequency);
-					serial->print(String() + "set-driver-frequency:{frequency:" + frequency + "}\n");
-				} else if (header == 'w') {
-					uint8_t hid       = channel.parse(16);
-					uint16_t duration = channel.parse(-1);
+				} else if (key == 4) {
+					// set-pwm value.
+					uint8_t hid       = channel.next( 4);
+					uint16_t duration = channel.next(12);
 					SetPWM(hid, duration);
-					serial->print(String() + "set-driver-duration:{channel:" + hid + ",duration:" + duration + "}\n");
-				} else if (header == 's') {
-					uint8_t hid = channel.parse(nHid);
-					removeSetter(hid);
-					serial->print(String() + "stop-set:{pin:" + hid + "}\n");
-				} else if (header == 't') {
-					uint8_t hid        = channel.parse(nHid);
-					uint32_t frequency = channel.parse(-1);
-					uint32_t duration  = channel.parse(-1);
+				} else if (key == 5) {
+					// Set tone.
+					uint8_t hid        = channel.next( 8);
+					uint32_t frequency = channel.next(16);
+					uint32_t duration  = channel.next(24);
 					noTone(tonePin);
 					tonePin = hid;
 					uint32_t durationMs = round(0.001L * duration);
 					if (frequency > 0 && durationMs > 0)
 						tone(hid, frequency, durationMs);
-					serial->print(String() + "set-tone:{pin:" + hid + ",frequency:" + frequency + ",duration:" + duration + "}\n");
-				} else if (header == 'B') {
-					uint8_t hid           = channel.parse(nHid);
-					uint32_t debounceRise = channel.parse(-1);
-					uint32_t debounceFall = channel.parse(-1);
-					uint8_t factor        = channel.parse(255);
+				} else if (key == 6 || key == 7) {
+					// set-port and set-ports.
+					uint8_t nports = key == 6 ? 1 : min(channel.next(8), nPorts);
+					uint8_t ports[nPorts];
+					uint8_t masks[nPorts];
+					uint8_t values[nPorts];
+					for (uint8_t i = 0; i < nports; i++) {
+						ports[i]  = channel.next(8);
+						masks[i]  = channel.next(8);
+						values[i] = channel.next(8);
+					}
+					writePorts(nports, ports, masks, values);
+				} else if (key == 8) {
+					// set-report.
+					setReport(channel.next(8));
+				} else if (key == 9) {
+					// set-queue.
+					setQueue(channel.next(8));
+				} else if (key == 10) {
+					// get-queue.
+					uint16_t overflows = edges.GetOverflows();
+					uint16_t dropped = rxFrame.errors;
+					uint8_t reply[] = {255, 10, (uint8_t) (queue.overflows[0] >> 8), (uint8_t) queue.overflows[0], (uint8_t) (queue.overflows[1] >> 8), (uint8_t) queue.overflows[1], (uint8_t) (overflows >> 8), (uint8_t) overflows, (uint8_t) (rxLost >> 8), (uint8_t) rxLost, (uint8_t) (dropped >> 8), (uint8_t) dropped};
+					queue.write(reply, sizeof(reply));
+				} else if (key == 11) {
+					// set-interval.
+					uint8_t hid       = channel.next( 8);
+					uint32_t interval = channel.next(24);
+					setInterval(hid, interval);
+				} else if (key == 12) {
+					// get-errors.
+					uint8_t hid = channel.next(8);
+					uint8_t index;
+					uint16_t count = getters.find(hid, index) ? getters.errors(index) : 0;
+					uint8_t reply[] = {255, 12, hid, (uint8_t) (count >> 8), (uint8_t) count};
+					queue.write(reply, sizeof(reply));
+				} else if (key == 15) {
+					// set-sweep.
+					uint8_t hid                = channel.next( 8);
+					uint8_t shape              = channel.next( 8);
+					uint64_t durationLowStart  = channel.next(24);
+					uint64_t durationLowStop   = channel.next(24);
+					uint64_t durationHighStart = channel.next(24);
+					uint64_t durationHighStop  = channel.next(24);
+					uint64_t duration          = channel.next(24);
+					removeSetter(hid);
+					addSetter(hid, Pools::setChirp.create(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration, (Chirp::Shape) (shape & 1)));
+				} else if (key == 16) {
+					// set-segments.
+					uint8_t index = channel.next(8);
+					uint8_t count = channel.next(8);
+					for (uint8_t i = 0; i < count; i++) {
+						uint8_t kind   = channel.next( 8);
+						uint32_t value = channel.next(24);
+						SetSequence::load(index + i, kind, value);
+					}
+				} else if (key == 17) {
+					// set-sequence.
+					uint8_t hid   = channel.next(8);
+					uint8_t start = channel.next(8);
+					removeSetter(hid);
+					addSetter(hid, Pools::setSequence.create(hid, start));
+				} else if (key == 18) {
+					// get-time.
+					uint64_t epoch = Timebase::epoch();
+					uint8_t reply[10] = {255, 18};
+					for (uint8_t i = 0; i < 8; i++)
+						reply[2 + i] = epoch >> (56 - 8 * i);
+					queue.write(reply, sizeof(reply));
+				} else if (key == 255) {
+					// get-binary.
+					uint8_t hid           = channel.next( 8);
+					uint64_t debounceRise = channel.next(24);
+					uint64_t debounceFall = channel.next(24);
+					uint8_t factor        = channel.next( 8);
 					removeGetter(hid);
-					getters.set(hid, new GetBinary(hid, debounceRise, debounceFall, max(factor, 1)));
-					//!! board::attachInterrupt(hid, changeCallback, CHANGE);
-					int8_t it = digitalPinToInterrupt(hid);
-					attachInterrupt(it, meta::Wrap(changeCallback, hid), CHANGE);
-					serial->print(String() + "get-binary:{pin:" + hid + ",debounce-rise:" + debounceRise + ",debounce-fall:" + debounceFall + ",factor:" + factor + "}\n");
-				} else if (header == 'C') {
-					uint8_t hid0          = channel.parse(nHid);
-					uint8_t hid1          = channel.parse(nHid);
-					uint8_t samples       = channel.parse(255);
-					uint8_t snr           = channel.parse(255);
-					uint32_t debounceRise = channel.parse(-1);
-					uint32_t debounceFall = channel.parse(-1);
+					if (addGetter(hid, Pools::getBinary.create(hid, debounceRise, debounceFall, max(factor, 1))))
+						attachEdges(hid, hid, CHANGE);
+				} else if (key == 254) {
+					// get-contact.
+					uint8_t hid0          = channel.next( 8);
+					uint8_t hid1          = channel.next( 8);
+					uint8_t samples       = channel.next( 8);
+					uint8_t snr           = channel.next( 8);
+					uint32_t debounceRise = channel.next(24);
+					uint32_t debounceFall = channel.next(24);
 					removeGetter(hid0);
 					removeGetter(hid1);
-					getters.set(hid0, new GetContact(hid0, hid1, samples, snr, debounceRise, debounceFall));
-					serial->print(String() + "get-contact:{pins:[" + hid0 + "," + hid1 + "]" + ",samples:" + samples + ",SNR:" + snr + ",debounce-rise:" + debounceRise + ",debounce-fall:" + debounceFall + "}\n");
-				} else if (header == 'L') {
-					uint8_t hid           = channel.parse(nHid);
-					uint32_t debounceRise = channel.parse(-1);
-					uint32_t debounceFall = channel.parse(-1);
+					addGetter(hid0, Pools::getContact.create(hid0, hid1, samples, snr, debounceRise, debounceFall));
+				} else if (key == 253) {
+					// get-level.
+					uint8_t hid           = channel.next( 8);
+					uint64_t debounceRise = channel.next(24);
+					uint64_t debounceFall = channel.next(24);
 					removeGetter(hid);
-					getters.set(hid, new GetLevel(hid, debounceRise, debounceFall));
-					serial->print(String() + "get-level:{pin:" + hid + ",debounce-rise:" + debounceRise + ",debounce-fall:" + debounceFall + "}\n");
-				} else if (header == 'R') {
-					uint8_t hid0   = channel.parse(nHid);
-					uint8_t hid1   = channel.parse(nHid);
-					uint8_t factor = channel.parse(255);
+					reclaimAdc();
+					addGetter(hid, Pools::getLevel.create(hid, debounceRise, debounceFall));
+				} else if (key == 252) {
+					// get-rotation.
+					uint8_t hid0   = channel.next( 8);
+					uint8_t hid1   = channel.next( 8);
+					uint8_t factor = channel.next( 8);
+					removeGetter(hid0);
+					removeGetter(hid1);
+					if (addGetter(hid0, Pools::getRotation.create(hid0, hid1, max(factor, 1))))
+						attachEdges(hid0, hid1, RISING);
+				} else if (key == 250) {
+					// get-quadrature.
+					uint8_t hid0   = channel.next( 8);
+					uint8_t hid1   = channel.next( 8);
+					uint8_t factor = channel.next( 8);
 					removeGetter(hid0);
 					removeGetter(hid1);
-					getters.set(hid0, new GetRotation(hid0, hid1, max(factor, 1)));
-					//!! board::attachInterrupt(hid0, risingCallback, RISING);
-					int8_t it = digitalPinToInterrupt(hid0);
-					attachInterrupt(it, meta::Wrap(risingCallback, hid0), RISING);
-					serial->print(String() + "get-rotation:{pins:[" + hid0 + "," + hid1 + "]" + ",factor:" + factor + "}\n");
-				} else if (header == 'S') {
-					uint8_t hid = channel.parse(nHid);
+					GetRotation* getter = Pools::getRotation.create(hid0, hid1, max(factor, 1), true);
+					if (addGetter(hid0, getter))
+						attachDecoder(hid0, hid1, getter->quadrature());
+				} else if (key == 248) {
+					// get-analog.
+					uint8_t hid       = channel.next( 8);
+					uint8_t filter    = channel.next( 8);
+					uint8_t parameter = channel.next( 8);
+					uint16_t deadband = channel.next(16);
 					removeGetter(hid);
-					serial->print(String() + "stop-get:{pin:" + hid + "}\n");
-				} else if (header == 'T') {
-					uint8_t hid           = channel.parse(nHid);
-					uint8_t threshold     = channel.parse(255);
-					uint32_t debounceRise = channel.parse(-1);
-					uint32_t debounceFall = channel.parse(-1);
+					reclaimAdc();
+					addGetter(hid, Pools::getLevel.create(hid, 0, 0, (AnalogFilter::Type) filter, parameter, deadband));
+				} else if (key == 247) {
+					// get-hysteresis.
+					uint8_t hid       = channel.next( 8);
+					uint16_t low      = channel.next(16);
+					uint16_t high     = channel.next(16);
+					uint8_t filter    = channel.next( 8);
+					uint8_t parameter = channel.next( 8);
 					removeGetter(hid);
-					getters.set(hid, new GetThreshold(hid, threshold, debounceRise, debounceFall));
-					serial->print(String() + "get-threshold:{pin:" + hid + ",threshold:" + threshold + ",debounce-rise:" + debounceRise + ",debounce-fall:" + debounceFall + "}\n");
-				}
-			} else if (status == Status::raw) {
-				uint8_t key = channel.read();
-				if (key < 254) {
-					// set-binary.
-					uint8_t hid;
-					bool state;
-					if (decodeState(key, hid, state)) {
-						removeSetter(hid);
-						SetBinary(hid, state);
-					}
-				} else if (key == 254) {
-					// set-address.
-					uint8_t address = channel.read();
-					uint8_t value = channel.read();
-					*reinterpret_cast<volatile uint8_t*>(address) = value;
-				} else if (key == 255) {
-					// Key continues with 1 more byte.
-					key = channel.read();
-					// Reset bit carret.
-					channel.next();
-					if (key == 0) {
-						// stop.
-						uint8_t hid = channel.next( 7);
-						bool choice	= channel.next( 1);
-						if (choice)
-							removeGetter(hid);
-						else
-							removeSetter(hid);
-					} else if (key == 1) {
-						// set-pulse.
-						uint8_t hid           = channel.next( 7);
-						bool stateStart       = channel.next( 1);
-						uint64_t durationLow  = channel.next(24);
-						uint64_t durationHigh = channel.next(24);
-						uint64_t repetitions  = channel.next(24);
-						removeSetter(hid);
-						setters.set(hid, new SetPulse(hid, stateStart, durationLow, durationHigh, repetitions));
-					} else if (key == 2) {
-						// set-chirp.
-						uint8_t hid                = channel.next( 8);
-						uint64_t durationLowStart  = channel.next(24);
-						uint64_t durationLowStop   = channel.next(24);
-						uint64_t durationHighStart = channel.next(24);
-						uint64_t durationHighStop  = channel.next(24);
-						uint64_t duration          = channel.next(24);
-						removeSetter(hid);
-						setters.set(hid, new SetChirp(hid, durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration));
-					} else if (key == 3) {
-						uint16_t frequency = channel.next(16);
-						// set-pwm frequency.
-						frequency = max(frequency, 24);
-						SetupPWM();
-						pwmDriver.setPWMFreq(frequency);
-					} else if (key == 4) {
-						// set-pwm value.
-						uint8_t hid       = channel.next( 4);
-						uint16_t duration = channel.next(12);
-						SetPWM(hid, duration);
-					} else if (key == 5) {
-						// Set tone.
-						uint8_t hid        = channel.next( 8);
-						uint32_t frequency = channel.next(16);
-						uint32_t duration  = channel.next(24);
-						noTone(tonePin);
-						tonePin = hid;
-						uint32_t durationMs = round(0.001L * duration);
-						if (frequency > 0 && durationMs > 0)
-							tone(hid, frequency, durationMs);
-					} else if (key == 255) {
-						// get-binary.
-						uint8_t hid           = channel.next( 8);
-						uint64_t debounceRise = channel.next(24);
-						uint64_t debounceFall = channel.next(24);
-						uint8_t factor        = channel.next( 8);
-						removeGetter(hid);
-						getters.set(hid, new GetBinary(hid, debounceRise, debounceFall, max(factor, 1)));
-						//!! board::attachInterrupt(hid, changeCallback, CHANGE);
-						int8_t it = digitalPinToInterrupt(hid);
-						attachInterrupt(it, meta::Wrap(changeCallback, hid), CHANGE);
-					} else if (key == 254) {
-						// get-contact.
-						uint8_t hid0          = channel.next( 8);
-						uint8_t hid1          = channel.next( 8);
-						uint8_t samples       = channel.next( 8);
-						uint8_t snr           = channel.next( 8);
-						uint32_t debounceRise = channel.next(24);
-						uint32_t debounceFall = channel.next(24);
-						removeGetter(hid0);
-						removeGetter(hid1);
-						getters.set(hid0, new GetContact(hid0, hid1, samples, snr, debounceRise, debounceFall));
-					} else if (key == 253) {
-						// get-level.
-						uint8_t hid           = channel.next( 8);
-						uint64_t debounceRise = channel.next(24);
-						uint64_t debounceFall = channel.next(24);
-						removeGetter(hid);
-						getters.set(hid, new GetLevel(hid, debounceRise, debounceFall));
-					} else if (key == 252) {
-						// get-rotation.
-						uint8_t hid0   = channel.next( 8);
-						uint8_t hid1   = channel.next( 8);
-						uint8_t factor = channel.next( 8);
-						removeGetter(hid0);
-						removeGetter(hid1);
-						getters.set(hid0, new GetRotation(hid0, hid1, max(factor, 1)));
-						//!! board::attachInterrupt(hid0, risingCallback, RISING);
-						int8_t it0 = digitalPinToInterrupt(hid0);
-						attachInterrupt(it0, meta::Wrap(risingCallback, hid0), RISING);
-					} else if (key == 251) {
-						uint8_t hid           = channel.next(8);
-						uint8_t threshold     = channel.next(8);
-						uint32_t debounceRise = channel.next(24);
-						uint32_t debounceFall = channel.next(24);
-						removeGetter(hid);
-						getters.set(hid, new GetThreshold(hid, threshold, debounceRise, debounceFall));
-					}
-				}
-			} else if (status == Status::handshake) {
-				switch (channel.read()) {
-					case 'r':
-						blink(13, 50, 10);
-						status = Status::raw;
-						reportFunction = reportRaw;
-						// instance->handshake();
-						break;
-					case 'd':
-						blink(13, 50, 10);
-						status = Status::debug;
-						reportFunction = reportText;
-						// instance->handshake();
-						break;
+					reclaimAdc();
+					addGetter(hid, Pools::getThreshold.create(hid, low, high, 0, 0, (AnalogFilter::Type) filter, parameter));
+				} else if (key == 246) {
+					// get-comparator.
+					uint8_t hid           = channel.next( 8);
+					uint16_t threshold    = channel.next(16);
+					uint8_t reference     = channel.next( 8);
+					uint32_t debounceRise = channel.next(24);
+					uint32_t debounceFall = channel.next(24);
+					removeGetter(hid);
+					if (addGetter(hid, Pools::getThreshold.create(hid, threshold, threshold, debounceRise, debounceFall, AnalogFilter::Type::None, 0, false)))
+						attachComparator(hid, (AnalogComparator::Reference) min(reference, 1));
+				} else if (key == 249) {
+					// get-stream.
+					uint8_t hid     = channel.next( 8);
+					uint16_t period = channel.next(16);
+					addStream(hid, period);
+				} else if (key == 251) {
+					uint8_t hid           = channel.next(8);
+					uint8_t threshold     = channel.next(8);
+					uint32_t debounceRise = channel.next(24);
+					uint32_t debounceFall = channel.next(24);
+					removeGetter(hid);
+					reclaimAdc();
+					addGetter(hid, Pools::getThreshold.create(hid, threshold, threshold, debounceRise, debounceFall));
 				}
 			}
+		} else if (status == Status::handshake) {
+			switch (channel.read()) {
+				case 'r':
+					blink(13, 50, 10);
+					status = Status::raw;
+					reportFunction = reportRaw;
+					// instance->handshake();
+					break;
+				case 'd':
+					blink(13, 50, 10);
+					status = Status::debug;
+					reportFunction = reportText;
+					// instance->handshake();
+					break;
+				case 'f':
+					blink(13, 50, 10);
+					status = Status::framed;
+					reportFunction = reportRaw;
+					break;
+			}
+		}
+	}
+	
+	// Register a setter created from its pool; the host is told when there was no room for it.
+	template<typename T>
+	bool Bridge::addSetter(int8_t hid, T* setter) {
+		if (setters.set(hid, setter)) {
+			// First step is due right away.
+			deadlines.schedule(hid, tic);
+			return true;
+		}
+		refuse(hid);
+		return false;
+	}
+	
+	// Register a getter created from its pool; the host is told when there was no room for it.
+	template<typename T>
+	bool Bridge::addGetter(int8_t hid, T* getter) {
+		if (getters.set(hid, getter))
+			return true;
+		refuse(hid);
+		return false;
+	}
+	
+	void Bridge::refuse(int8_t hid) {
+		if (status == Status::debug) {
+			Text(&queue) << F("refused:{pin:") << hid << F("}\n");
+		} else {
+			uint8_t reply[] = {255, 13, (uint8_t) hid};
+			queue.write(reply, sizeof(reply));
 		}
 	}
 	
 	void Bridge::removeSetter(int8_t hid) {
-		// cli();
-		Routine* routine;
-		if (setters.get(hid, routine)) {
-			setters.unset(hid);
-			routine->stop();
-			delete routine;
+		deadlines.remove(hid);
+		setters.unset(hid);
+	}
+	
+	// Reclaim a setter that finished on its own, and tell the host if requested.
+	void Bridge::retire(int8_t hid) {
+		removeSetter(hid);
+		if (!completions)
+			return;
+		if (status == Status::debug) {
+			Text(&queue) << F("done:{pin:") << hid << F("}\n");
+		} else {
+			uint8_t reply[] = {255, 14, (uint8_t) hid};
+			queue.write(reply, sizeof(reply));
 		}
-		// sei();
 	}
 	
+	// Interrupts stop serving a getter before it is destroyed.
 	void Bridge::removeGetter(int8_t hid) {
-		// cli();
-		//!! board::detachInterrupt(hid);
-		detachInterrupt(digitalPinToInterrupt(hid));
-		Routine* routine;
-		if (getters.get(hid, routine)) {
-			getters.unset(hid);
-			routine->stop();
-			delete routine;
+		detach(hid);
+		getters.unset(hid);
+		if (hid == streamPin) {
+			AnalogSampler::Unstream();
+			streamPin = 255;
+		}
+	}
+	
+	// Stream an analog pin in place of its getter, and of any previous stream.
+	void Bridge::addStream(uint8_t hid, uint16_t period) {
+		removeGetter(hid);
+		if (streamPin != 255)
+			removeGetter(streamPin);
+		reclaimAdc();
+		if (AnalogSampler::Stream(hid, period)) {
+			streamPin = hid;
+			streamPeriod = period;
+		} else {
+			refuse(hid);
 		}
-		// sei();
+	}
+	
+	// Write the masked bits of one or more ports at once. Setters and getters on affected pins are stopped first.
+	void Bridge::writePorts(uint8_t nports, uint8_t* ports, uint8_t* masks, uint8_t* values) {
+		volatile uint8_t* outputs[nPorts];
+		volatile uint8_t* modes[nPorts];
+		for (uint8_t i = 0; i < nports; i++) {
+			bool exists = false;
+			for (uint8_t hid = 0; hid < NUM_DIGITAL_PINS; hid++) {
+				if (digitalPinToPort(hid) == ports[i]) {
+					exists = true;
+					if (digitalPinToBitMask(hid) & masks[i]) {
+						removeSetter(hid);
+						removeGetter(hid);
+					}
+				}
+			}
+			if (exists) {
+				outputs[i] = portOutputRegister(ports[i]);
+				modes[i] = portModeRegister(ports[i]);
+			} else {
+				masks[i] = 0;
+			}
+		}
+		
+		// Values are written before directions so that inputs become outputs with the requested state.
+		noInterrupts();
+		for (uint8_t i = 0; i < nports; i++) {
+			if (masks[i]) {
+				*outputs[i] = (*outputs[i] & ~masks[i]) | (values[i] & masks[i]);
+				*modes[i] |= masks[i];
+			}
+		}
+		interrupts();
 	}
 	
 	void Bridge::SetPWM(uint8_t hid, uint16_t duration) {
@@ -615,9 +1505,9 @@ namespace bridge {
 	}
 	
 	void Bridge::blink(int8_t hid, uint16_t halfDuration, uint16_t repetitions) {
-		uint64_t tics = 1000 * halfDuration;
+		uint32_t tics = 1000UL * halfDuration;
 		removeSetter(hid);
-		setters.set(hid, new SetPulse(hid, 1, tics, tics, repetitions));
+		addSetter(hid, Pools::setPulse.create(hid, 1, tics, tics, repetitions));
 	}
 	
 	uint8_t Bridge::encodeState(uint8_t hid, bool state) {
@@ -638,55 +1528,407 @@ namespace bridge {
 		}
 	}
 	
-	// Notify inputs of an iteration.
+	// Notify inputs of an iteration. Getters whose edges are handed to them opt out at registration.
 	void Bridge::getterRoutine() {
-		Routine* routine;
-		getters.begin();
-		while (getters.next(routine)) {
-			if (digitalPinToInterrupt(routine->index()) == -1)
-				routine->step(tic);
+		for (uint8_t index = 0; index < getters.size(); index++) {
+			if (getters.at(index)->stepped)
+				getters.step(index, tic);
 		}
 	}
 	
-	// Notify outputs of an iteration.
+	// Step the outputs whose deadline passed, earliest first; outputs waiting for their deadline cost nothing.
 	void Bridge::setterRoutine() {
-		Routine* routine;
-		setters.begin();
-		while (setters.next(routine))
-			routine->step(tic);
+		uint8_t hid;
+		uint32_t deadline;
+		while (deadlines.top(hid, deadline) && Timebase::reached(tic, deadline)) {
+			uint8_t index;
+			if (!setters.find(hid, index)) {
+				deadlines.remove(hid);
+			} else if (setters.step(index, tic)) {
+				// An output is stepped at most once per Step.
+				deadline = setters.at(index)->deadline;
+				if (Timebase::reached(tic, deadline))
+					deadline = tic + 1;
+				deadlines.schedule(hid, deadline);
+			} else {
+				retire(hid);
+			}
+		}
 	}
 	
-	void Bridge::risingCallback(uintptr_t hid) {
-		Routine* routine;
-		if (getters.get(hid, routine))
-			routine->step(tic, 255);
+	// Capture edges of a getter's pin with an interrupt, if available, along with the state of a sample pin read at that time.
+	void Bridge::attachEdges(int8_t hid, int8_t sample, int mode) {
+		bool attached = attach(hid, hid, sample, mode, nullptr);
+		uint8_t index;
+		if (getters.find(hid, index))
+			getters.attached(index, attached);
+	}
+	
+	// Sample a quadrature decoder on every change of either pin. The getter polls unless both pins have an interrupt.
+	void Bridge::attachDecoder(int8_t hid0, int8_t hid1, Quadrature* decoder) {
+		bool attached0 = attach(hid0, hid0, hid0, CHANGE, decoder);
+		bool attached1 = attach(hid1, hid0, hid1, CHANGE, decoder);
+		uint8_t index;
+		if (getters.find(hid0, index))
+			getters.attached(index, attached0 && attached1);
+	}
+	
+	// Detect crossings of a pin with the analog comparator when it reaches the pin; the getter samples it with the ADC otherwise.
+	void Bridge::attachComparator(int8_t hid, AnalogComparator::Reference reference) {
+		bool attached = AnalogComparator::Attach(hid, reference, compare, hid);
+		if (!attached)
+			reclaimAdc();
+		uint8_t index;
+		if (getters.find(hid, index))
+			getters.attached(index, attached);
+	}
+	
+	// Give the ADC back to analog getters and streams; a get-comparator pin reached through its multiplexer is sampled instead.
+	void Bridge::reclaimAdc() {
+		int8_t hid = AnalogComparator::Multiplexed();
+		if (hid < 0)
+			return;
+		AnalogComparator::Detach(hid);
+		uint8_t index;
+		if (getters.find(hid, index))
+			getters.attached(index, false);
+	}
+	
+	// Serve a getter with the external interrupt of a pin, else with its pin change interrupt, else by polling its port; false if none is available.
+	bool Bridge::attach(int8_t pin, int8_t hid, int8_t sample, int mode, Quadrature* decoder) {
+		static const VoidFunction captures[nInterrupts] = {capture<0>, capture<1>, capture<2>, capture<3>, capture<4>, capture<5>, capture<6>, capture<7>};
+		int8_t external = digitalPinToInterrupt(pin);
+		uint8_t id;
+		if (external >= 0 && external < nInterrupts) {
+			id = external;
+		} else {
+			// Pins without a pin change interrupt, or in excess of the slots available, are polled.
+			for (id = digitalPinToPCICR(pin) ? nInterrupts : nPolled; id < nSources && sourcePins[id] != 255; id++) {}
+			if (id == nSources)
+				return false;
+		}
+		sourcePins[id] = hid;
+		sourceTriggers[id] = pin;
+		samplePorts[id] = BRIDGE_BASEREG(sample);
+		sampleMasks[id] = BRIDGE_BITMASK(sample);
+		risings[id] = mode == RISING;
+		decoders[id] = decoder;
+		if (id < nInterrupts) {
+			attachInterrupt(id, captures[id], mode);
+		} else if (!(id < nPolled ? PinChange::Attach(pin, pinChange, id) : attachPoll(id))) {
+			sourcePins[id] = 255;
+			decoders[id] = nullptr;
+			return false;
+		}
+		return true;
+	}
+	
+	// Watch the trigger pin of a source in the snapshot of its port; false when all polled ports are taken.
+	bool Bridge::attachPoll(uint8_t id) {
+		uint8_t pin = sourceTriggers[id];
+		if (pin >= NUM_DIGITAL_PINS)
+			return false;
+		volatile uint8_t* port = BRIDGE_BASEREG(pin);
+		uint8_t mask = BRIDGE_BITMASK(pin);
+		uint8_t p;
+		for (p = 0; p < nPollPorts && !(pollMasks[p] && pollPorts[p] == port); p++) {}
+		if (p == nPollPorts) {
+			for (p = 0; p < nPollPorts && pollMasks[p]; p++) {}
+			if (p == nPollPorts)
+				return false;
+			pollPorts[p] = port;
+		}
+		uint8_t bit = 0;
+		while (!(mask & (1 << bit)))
+			bit++;
+		pollSources[p][bit] = id;
+		// Start from the current state so that registering does not count as an edge.
+		pollStates[p] = (pollStates[p] & ~mask) | (*port & mask);
+		pollMasks[p] |= mask;
+		return true;
+	}
+	
+	// Detach interrupts serving a getter, or stop polling its pins.
+	void Bridge::detach(int8_t hid) {
+		AnalogComparator::Detach(hid);
+		for (uint8_t id = 0; id < nSources; id++) {
+			if (sourcePins[id] == hid) {
+				if (id < nInterrupts)
+					detachInterrupt(id);
+				else if (id < nPolled)
+					PinChange::Detach(sourceTriggers[id]);
+				else
+					detachPoll(id);
+				sourcePins[id] = 255;
+				decoders[id] = nullptr;
+			}
+		}
+	}
+	
+	// Remove the trigger pin of a source from the snapshot of its port.
+	void Bridge::detachPoll(uint8_t id) {
+		uint8_t pin = sourceTriggers[id];
+		volatile uint8_t* port = BRIDGE_BASEREG(pin);
+		for (uint8_t p = 0; p < nPollPorts; p++) {
+			if (pollPorts[p] == port)
+				pollMasks[p] &= ~BRIDGE_BITMASK(pin);
+		}
+	}
+	
+	// Read each polled port once, and serve only the sources whose pins changed since the previous snapshot.
+	void Bridge::poll() {
+		uint8_t index;
+		for (uint8_t p = 0; p < nPollPorts; p++) {
+			uint8_t mask = pollMasks[p];
+			if (mask == 0)
+				continue;
+			uint8_t state = *pollPorts[p];
+			uint8_t changes = (state ^ pollStates[p]) & mask;
+			pollStates[p] = state;
+			for (uint8_t bit = 0; changes; bit++, changes >>= 1) {
+				if (!(changes & 1))
+					continue;
+				uint8_t id = pollSources[p][bit];
+				if (risings[id] && !(state & (1 << bit)))
+					continue;
+				Quadrature* decoder = decoders[id];
+				if (decoder) {
+					// The decoder may also be sampled by an interrupt on the other pin.
+					noInterrupts();
+					decoder->Sample();
+					interrupts();
+				} else if (getters.find(sourcePins[id], index)) {
+					// Samples on the same port come from the snapshot.
+					uint8_t sample = samplePorts[id] == pollPorts[p] ? state : *samplePorts[id];
+					getters.step(index, tic, (sample & sampleMasks[id]) ? 1 : 0);
+				}
+			}
+		}
+	}
+	
+	// Decode quadrature, or queue the time of the edge and the state of the sample pin. Runs in the interrupt context.
+	inline void Bridge::serve(uint8_t id) {
+		Quadrature* decoder = decoders[id];
+		if (decoder)
+			decoder->Sample();
+		else
+			edges.Push(sourcePins[id], BRIDGE_READ(samplePorts[id], sampleMasks[id]));
+	}
+	
+	// Interrupt service routine of an external interrupt.
+	template<uint8_t id>
+	void Bridge::capture() {
+		serve(id);
+	}
+	
+	// Pin change interrupts report both edges; rising edges are filtered here when only those were requested.
+	void Bridge::pinChange(uintptr_t id, bool state) {
+		if (state || !risings[id])
+			serve(id);
 	}
 	
-	void Bridge::changeCallback(uintptr_t hid) {
+	// Crossings of the analog comparator are queued as edges, with the time they happened.
+	void Bridge::compare(uintptr_t hid, bool state) {
+		edges.Push(hid, state);
+	}
+	
+	// Send full blocks of the analog stream: raw blocks pack 4 samples per 5 bytes, text lines hold up to 8 samples each.
+	void Bridge::stream() {
+		AnalogSampler::Block* block;
+		while (streamPin != 255 && (block = AnalogSampler::Take())) {
+			const uint16_t* samples = block->samples;
+			if (status == Status::debug) {
+				for (uint8_t offset = 0; offset < AnalogSampler::blockSize; offset += 8) {
+					queue.open(Queue::Priority::bulk);
+					{
+						Text text(&queue);
+						text << F("stream:{pin:") << streamPin << F(",sequence:") << block->sequence << F(",tic:") << (uint32_t) (block->tic + (uint32_t) offset * streamPeriod) << F(",samples:[");
+						for (uint8_t i = offset; i < offset + 8 && i < AnalogSampler::blockSize; i++) {
+							if (i > offset)
+								text << ',';
+							text << samples[i];
+						}
+						text << F("]}\n");
+					}
+					queue.close();
+				}
+			} else {
+				queue.open(Queue::Priority::bulk);
+				uint8_t header[] = {255, 249, streamPin, block->sequence, (uint8_t) (block->tic >> 24), (uint8_t) (block->tic >> 16), (uint8_t) (block->tic >> 8), (uint8_t) block->tic};
+				queue.write(header, sizeof(header));
+				for (uint8_t i = 0; i < AnalogSampler::blockSize; i += 4) {
+					queue.write(samples[i + 0] >> 2);
+					queue.write(samples[i + 0] << 6 | samples[i + 1] >> 4);
+					queue.write(samples[i + 1] << 4 | samples[i + 2] >> 6);
+					queue.write(samples[i + 2] << 2 | samples[i + 3] >> 8);
+					queue.write(samples[i + 3]);
+				}
+				queue.close();
+			}
+			AnalogSampler::Release();
+		}
+	}
+	
+	// Hand captured edges to their getters, in order and with the time they happened.
+	void Bridge::drain() {
+		Edges::Edge edge;
+		uint8_t index;
+		while (edges.Pop(edge)) {
+			if (getters.find(edge.pin, index))
+				getters.step(index, edge.tic, edge.state);
+		}
+	}
+	
+	// Select the report format. Flags: bit 0 compact (raw and framed modes), bit 1 timestamps (compact and debug modes), bit 2 completion of setters.
+	void Bridge::setReport(uint8_t flags) {
+		if (status != Status::debug)
+			reportFunction = (flags & 1) ? reportCompact : reportRaw;
+		timestamps = flags & 2;
+		completions = flags & 4;
+		// The first timestamp is relative to zero.
+		reportTic = 0;
+	}
+	
+	// Select what happens to reports that do not fit in the queue. Flags: bit 0 coalesce, bit 1 adaptive report intervals.
+	void Bridge::setQueue(uint8_t flags) {
+		queue.policy = (flags & 1) ? Queue::Policy::coalesce : Queue::Policy::drop;
+		adaptive = flags & 2;
+	}
+	
+	// Set the minimum time between reports of a getter, or of all getters without one of their own when hid is 255.
+	void Bridge::setInterval(uint8_t hid, uint32_t interval) {
 		Routine* routine;
-		if (getters.get(hid, routine))
-			routine->step(tic, 255);
+		if (hid == 255)
+			reportInterval = interval;
+		else if (getters.get(hid, routine))
+			routine->reportInterval = interval;
 	}
 	
-	void Bridge::reportText(int8_t hid, int32_t value, int32_t delta) {
-		if (delta != 0) {
-			serial->print(String() + "pin:" + hid + ",value:" + value + ",delta:" + delta + "\n");
+	// Whether a getter may report. Getters keep accumulating changes in between, so one report summarizes the interval.
+	bool Bridge::due(Routine* routine) {
+		uint32_t interval = routine->reportInterval > 0 ? routine->reportInterval : reportInterval;
+		// Double the interval for each quarter of the queue in use, starting from a base interval when none was set.
+		if (adaptive) {
+			uint8_t quarters = max(queue.occupancy(Queue::Priority::event), queue.occupancy(Queue::Priority::bulk)) >> 6;
+			if (quarters > 0)
+				interval = (interval > 0 ? interval : BRIDGE_ADAPTIVE_INTERVAL) << quarters;
 		}
+		return tic - routine->reportTic >= interval;
 	}
 	
-	// Change reports consist of 1 byte indicating pin and direction of change.
-	void Bridge::reportRaw(int8_t hid, int32_t value, int32_t delta) {
-		// serial->println(delta);
-		
-		uint8_t state;
-		if (delta > 0) {
-			state = encodeState(hid, 1);
-		} else if (delta < 0) {
-			state = encodeState(hid, 0);
-			delta = -delta;
+	// Discrete events go out ahead of streams.
+	Queue::Priority Bridge::priority(Kind kind) {
+		return kind == Kind::level || kind == Kind::rotation ? Queue::Priority::bulk : Queue::Priority::event;
+	}
+	
+	// Part of delta a getter may consider reported: what was queued, or all of it when the drop policy gives up a report that did not fit.
+	int32_t Bridge::settle(int32_t queued, int32_t delta) {
+		reported |= queued != 0;
+		return queued == 0 && queue.policy == Queue::Policy::drop ? delta : queued;
+	}
+	
+	int32_t Bridge::reportText(int8_t hid, Kind kind, uint32_t tic, int32_t value, int32_t delta) {
+		if (delta == 0)
+			return 0;
+		queue.open(priority(kind));
+		{
+			Text text(&queue);
+			text << F("pin:") << hid << F(",value:") << value << F(",delta:") << delta;
+			if (timestamps)
+				text << F(",tic:") << tic;
+			text << '\n';
+		}
+		return settle(queue.close() ? delta : 0, delta);
+	}
+	
+	// Change reports consist of 1 byte indicating pin and direction of change, once per unit of change.
+	// Long runs span several records, each fitting the queue; the first record refused ends the report.
+	// The host sums these bytes, hence what was not queued is left to the getter regardless of the policy.
+	int32_t Bridge::reportRaw(int8_t hid, Kind kind, uint32_t tic, int32_t value, int32_t delta) {
+		if (delta == 0)
+			return 0;
+		uint8_t state = encodeState(hid, delta > 0);
+		int32_t total = delta > 0 ? delta : -delta;
+		int32_t queued = 0;
+		while (queued < total) {
+			int32_t n = total - queued;
+			if (n > BRIDGE_QUEUE_SIZE - 1)
+				n = BRIDGE_QUEUE_SIZE - 1;
+			queue.open(priority(kind));
+			for (int32_t v = 0; v < n; v++)
+				queue.write(state);
+			if (!queue.close())
+				break;
+			queued += n;
 		}
-		for (int8_t v = 0; v < delta; v++) {
-			serial->write(state);
+		reported |= queued > 0;
+		return delta > 0 ? queued : -queued;
+	}
+	
+	// Compact reports consist of the pin, the kind of getter, and a zigzag-encoded varint with the absolute value (level) or the delta (all others).
+	// With timestamps, a second varint holds the time of the event relative to the previous timestamped report.
+	int32_t Bridge::reportCompact(int8_t hid, Kind kind, uint32_t tic, int32_t value, int32_t delta) {
+		if (delta == 0)
+			return 0;
+		queue.open(priority(kind));
+		queue.write(hid);
+		queue.write((uint8_t) kind);
+		sendVarint(kind == Kind::level ? value : delta);
+		// Events are reported per getter, hence their times may precede the previous report's.
+		if (timestamps)
+			sendVarint(tic - reportTic);
+		bool accepted = queue.close();
+		if (accepted && timestamps)
+			reportTic = tic;
+		return settle(accepted ? delta : 0, delta);
+	}
+	
+	// Send a signed number as a zigzag-encoded varint: 7 bits per byte, least significant group first.
+	void Bridge::sendVarint(int32_t number) {
+		uint32_t zigzag = ((uint32_t) number << 1) ^ (uint32_t) (number >> 31);
+		while (zigzag >= 0x80) {
+			queue.write((uint8_t) zigzag | 0x80);
+			zigzag >>= 7;
+		}
+		queue.write(zigzag);
+	}
+	
+	// Move queued bytes into the serial port as far as its transmit buffer allows, so that writing never blocks.
+	void Bridge::flush() {
+		int room = serial->availableForWrite();
+		if (status == Status::framed) {
+			while (room > 0) {
+				if (txOffset == txLength) {
+					// Compose the next frame from whole records, unless a record is larger than a frame.
+					txFrame.begin(txSequence);
+					uint8_t n;
+					while ((n = queue.pending()) > 0 && (n <= txFrame.room() || txFrame.empty())) {
+						uint8_t byte;
+						for (n = min(n, txFrame.room()); n > 0 && queue.pop(byte); n--)
+							txFrame.add(byte);
+					}
+					if (txFrame.empty())
+						break;
+					txLength = txFrame.finish();
+					txOffset = 0;
+					txSequence++;
+				}
+				uint8_t n = min(room, txLength - txOffset);
+				serial->write(txFrame.bytes() + txOffset, n);
+				txOffset += n;
+				room -= n;
+			}
+		} else {
+			uint8_t byte;
+			while (room-- > 0 && queue.pop(byte))
+				serial->write(byte);
 		}
 	}
 }
+
+// Service routines of the interrupts used above.
+BRIDGE_COMPARATOR_VECTORS
+BRIDGE_PINCHANGE_VECTORS
+BRIDGE_PULSE_VECTORS
+BRIDGE_SAMPLER_VECTORS
+BRIDGE_SCHEDULER_VECTORS
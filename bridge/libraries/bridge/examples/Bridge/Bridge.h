@@ -2,64 +2,189 @@
 #define BRIDGE_H
 
 #include <stdint.h>
-#include "WString.h"
 #include "HardwareSerial.h"
 #include "Adafruit_PWMServoDriver.h"
 
 #include "Channel.h"
-#include "LinkedIndex.h"
+#include "DeadlineHeap.h"
+#include "EdgeBuffer.h"
+#include "Frame.h"
+#include "Quadrature.h"
+#include "Queue.h"
 #include "Stepper.h"
 #include "Routine.h"
+#include "RoutineTable.h"
+#include "types.h"
 
 using PWMDriver = Adafruit_PWMServoDriver;
 
+/// Number of setters and getters running at once.
+#ifndef BRIDGE_SETTERS
+#define BRIDGE_SETTERS 32
+#endif
+#ifndef BRIDGE_GETTERS
+#define BRIDGE_GETTERS 32
+#endif
+
+/// Number of edges captured by interrupts between two calls to Step (a power of two).
+#ifndef BRIDGE_EDGES_SIZE
+#define BRIDGE_EDGES_SIZE 32
+#endif
+
+/// Number of pins served by pin change interrupts.
+#ifndef BRIDGE_PIN_CHANGES
+#define BRIDGE_PIN_CHANGES 8
+#endif
+
+/// Number of pins served by polling port snapshots.
+#ifndef BRIDGE_POLLED
+#define BRIDGE_POLLED 16
+#endif
+
+/// Report interval (us) doubled by adaptive intervals for getters without any interval.
+#ifndef BRIDGE_ADAPTIVE_INTERVAL
+#define BRIDGE_ADAPTIVE_INTERVAL 1000
+#endif
+
+/// Number of ports that polled pins may span.
+#ifndef BRIDGE_POLL_PORTS
+#if defined(PINL)
+#define BRIDGE_POLL_PORTS 12
+#else
+#define BRIDGE_POLL_PORTS 4
+#endif
+#endif
+
 namespace bridge {
 	class Bridge : public Stepper {
 		public:
 			Bridge();
 			Bridge(HardwareSerial* serial, uint32_t baudrate);
 			void Step() override;
+			void SetReadBudget(uint8_t nbytes, uint32_t duration);
 		
 		// private:
 			enum class Status {
 				disabled,	///< Setting up
 				handshake,	///< Waiting for handshake
 				debug,		///< Using debug mode as communication protocol
+				framed,		///< Using raw mode wrapped in checksummed frames as communication protocol
 				raw = 255	///< Using raw mode as communication protocol
 			};
 			
+			static const uint8_t nHid = 69;			// Max number of indexed elements.
+			typedef RoutineTable<BRIDGE_SETTERS, nHid> Setters;
+			typedef RoutineTable<BRIDGE_GETTERS, nHid> Getters;
+			
 			static Bridge* instance;
 			static HardwareSerial* serial;
-			static LinkedIndex<Routine*> setters;	// Linked list of not null output* elements from the array.
-			static LinkedIndex<Routine*> getters;	// Linked list of not null input* elements from the array.
-			static const uint8_t nHid = 69;			// Max number of indexed elements.
+			static Setters setters;					// Outputs, indexed by pin.
+			static DeadlineHeap<BRIDGE_SETTERS, nHid> deadlines;	// Pins of setters by the time of their next step.
+			static Getters getters;					// Inputs, indexed by pin.
+			static const uint8_t nPorts = (BRIDGE_CHANNEL_SIZE - 3) / 3;	// Max number of ports written by one command.
+			static const uint8_t nSegments = (BRIDGE_CHANNEL_SIZE - 4) / 4;	// Max number of entries written by one command.
 			static uint32_t baudrate;
+			
+			typedef EdgeBuffer<BRIDGE_EDGES_SIZE> Edges;
+			static const uint8_t nInterrupts = 8;	// Number of external interrupts (INT0 to INT7).
+			static const uint8_t nPolled = nInterrupts + BRIDGE_PIN_CHANGES;	// First source served by polling.
+			static const uint8_t nSources = nPolled + BRIDGE_POLLED;	// External interrupts, pin change interrupts, then polled pins.
+			static const uint8_t nPollPorts = BRIDGE_POLL_PORTS;
+			static Edges edges;						// Edges captured by interrupts, handed to getters during Step.
+			static uint8_t sourcePins[nSources];				// Getter pin served by each source, 255 when unused.
+			static uint8_t sourceTriggers[nSources];			// Pin triggering each source.
+			static volatile uint8_t* samplePorts[nSources];	// Input register of the pin sampled on each trigger.
+			static uint8_t sampleMasks[nSources];				// Mask of the pin sampled on each trigger.
+			static bool risings[nSources];						// Whether only rising edges are served (pin change interrupts and polled pins).
+			static Quadrature* decoders[nSources];				// Decoder sampled on each trigger, if any, instead of handing edges over.
+			static volatile uint8_t* pollPorts[nPollPorts];		// Input register of each polled port, nullptr when unused.
+			static uint8_t pollMasks[nPollPorts];				// Polled bits of each port.
+			static uint8_t pollStates[nPollPorts];				// Last snapshot of each polled port.
+			static uint8_t pollSources[nPollPorts][8];			// Source polled at each bit of each port.
 			static PWMDriver pwmDriver;
 			static uint8_t tonePin;
 			static Status status;
+			static uint8_t readBytes;				// Max number of bytes consumed from serial per Step.
+			static uint32_t readDuration;			// Max duration (us) spent reading serial per Step.
 			static ReportFunction reportFunction;
+			static uint32_t reportInterval;			// Minimum time (us) between reports of getters without an interval of their own.
+			static bool adaptive;					// Whether report intervals stretch as the queue fills up.
+			static bool reported;					// Whether the last call to report sent something.
+			static bool timestamps;					// Whether reports include the time of the event.
+			static bool completions;				// Whether the host is told when a setter finishes.
+			static uint32_t reportTic;				// Time of the last timestamped report.
+			static uint8_t streamPin;				// Pin of the analog stream, 255 when none.
+			static uint16_t streamPeriod;			// Time (us) between samples of the analog stream.
+			
+			static Queue queue;						// Reports and replies waiting for room in the serial transmit buffer.
+			static Frame txFrame;					// Frame batching reports in framed mode.
+			static uint8_t txSequence;				// Sequence number of the next frame sent.
+			static uint8_t txLength;				// Number of bytes of the frame being sent.
+			static uint8_t txOffset;				// Number of bytes of the frame already sent.
+			static uint8_t rxSequence;				// Sequence number of the last frame received.
+			static uint16_t rxLost;					// Number of frames from the host missing from the sequence.
 			
 			bool pwmSetup;
+			bool rxSynced;							// Whether a frame has been received.
+			uint16_t discard;						// Bytes left of a raw command that was dropped.
 			Channel channel;
+			Frame rxFrame;
 			void handshake();
 			void read();
+			void consume(uint8_t byte);
+			void drop(uint8_t nreceived);
+			bool complete();
+			uint16_t declared();
+			bool supported();
+			void execute();
 			void blink(int8_t hid, uint16_t halfDuration, uint16_t repetitions);
-			void addGetter(int8_t hid, Routine* routine);
-			void addSetter(int8_t hid, Routine* routine);
-			void removeSetter(int8_t hid);
+			template<typename T>
+			static bool addSetter(int8_t hid, T* setter);
+			template<typename T>
+			static bool addGetter(int8_t hid, T* getter);
+			static void refuse(int8_t hid);
+			static void retire(int8_t hid);
+			static void removeSetter(int8_t hid);
 			void removeGetter(int8_t hid);
+			void addStream(uint8_t hid, uint16_t period);
+			void writePorts(uint8_t nports, uint8_t* ports, uint8_t* masks, uint8_t* values);
 			void SetPWM(uint8_t hid, uint16_t duration);
 			void SetupPWM();
 			
 			static void getterRoutine();
 			static void setterRoutine();
-			static void risingCallback(uintptr_t hid);
-			static void changeCallback(uintptr_t hid);
+			static void attachEdges(int8_t hid, int8_t sample, int mode);
+			static void attachDecoder(int8_t hid0, int8_t hid1, Quadrature* decoder);
+			static void attachComparator(int8_t hid, AnalogComparator::Reference reference);
+			static void reclaimAdc();
+			static bool attach(int8_t pin, int8_t hid, int8_t sample, int mode, Quadrature* decoder);
+			static bool attachPoll(uint8_t id);
+			static void detach(int8_t hid);
+			static void detachPoll(uint8_t id);
+			static void poll();
+			static void serve(uint8_t id);
+			static void pinChange(uintptr_t id, bool state);
+			static void compare(uintptr_t hid, bool state);
+			template<uint8_t id>
+			static void capture();
+			static void drain();
+			static void stream();
 			static uint8_t encodeState(uint8_t hid, bool state);
 			static bool decodeState(uint8_t code, uint8_t &pin, bool &state);
 			
-			static void reportText(int8_t hid, int32_t current, int32_t delta);
-			static void reportRaw(int8_t hid, int32_t current, int32_t delta);
+			static void flush();
+			
+			static void sendVarint(int32_t number);
+			static void setReport(uint8_t flags);
+			static void setQueue(uint8_t flags);
+			static void setInterval(uint8_t hid, uint32_t interval);
+			static bool due(Routine* routine);
+			static Queue::Priority priority(Kind kind);
+			
+			static int32_t settle(int32_t queued, int32_t delta);
+			static int32_t reportText(int8_t hid, Kind kind, uint32_t tic, int32_t current, int32_t delta);
+			static int32_t reportRaw(int8_t hid, Kind kind, uint32_t tic, int32_t current, int32_t delta);
+			static int32_t reportCompact(int8_t hid, Kind kind, uint32_t tic, int32_t current, int32_t delta);
 	};
 }
 #endif
\ No newline at end of file
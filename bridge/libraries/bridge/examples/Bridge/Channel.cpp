@@ -2,24 +2,52 @@
 #include "Channel.h"
 
 namespace bridge {
-	Channel::Channel() {
+	// Masks isolating the n lowest bits of the accumulator.
+	const uint32_t Channel::masks[25] PROGMEM = {
+		0x000000, 0x000001, 0x000003, 0x000007, 0x00000F, 0x00001F, 0x00003F, 0x00007F, 0x0000FF,
+		          0x0001FF, 0x0003FF, 0x0007FF, 0x000FFF, 0x001FFF, 0x003FFF, 0x007FFF, 0x00FFFF,
+		          0x01FFFF, 0x03FFFF, 0x07FFFF, 0x0FFFFF, 0x1FFFFF, 0x3FFFFF, 0x7FFFFF, 0xFFFFFF
+	};
+	
+	Channel::Channel() : accumulator(0), nremainder(0), length(0), position(0) {
+	}
+	
+	// Append a byte to the command being assembled.
+	bool Channel::push(uint8_t byte) {
+		if (length < BRIDGE_CHANNEL_SIZE) {
+			frame[length++] = byte;
+			return true;
+		} else {
+			return false;
+		}
+	}
+	
+	// Drop the pending command and reset the bit carret.
+	void Channel::clear() {
+		length = 0;
+		position = 0;
+		next();
 	}
 	
-	Channel::Channel(HardwareSerial* serial) : nremainder(0) {
-		this->serial = serial;
-		buffer[0] = 0;
+	uint8_t Channel::size() {
+		return length;
 	}
-	 
-	// Block until successful peek.
+	
+	uint8_t Channel::at(uint8_t i) {
+		return i < length ? frame[i] : 0;
+	}
+	
+	bool Channel::available() {
+		return position < length;
+	}
+	
+	// Commands are only executed once complete, hence reads past the end yield 0 rather than block.
 	uint8_t Channel::peek() {
-		while (!serial->available()) {}
-		return serial->peek();
+		return position < length ? frame[position] : 0;
 	}
 	
-	// Block until successful read.
 	uint8_t Channel::read() {
-		while (!serial->available()) {}
-		return serial->read();
+		return position < length ? frame[position++] : 0;
 	}
 	
 	// Read a number of bytes.
@@ -36,7 +64,7 @@ namespace bridge {
 		// Digit: 0 to 9 and the letter m (max).
 		// Drop all characters until the first digit is found.
 		uint8_t k = 0;
-		while (true) {
+		while (available()) {
 			k = peek();
 			if (k == 'm')
 				break;
@@ -56,7 +84,7 @@ namespace bridge {
 			uint8_t buffer[20]{0};
 			uint8_t pos = 0;
 			bool bound = true;
-			while (true) {
+			while (available()) {
 				k = peek();
 				if (k >= '0' && k <= '9') {
 					if (pos < 20)
@@ -98,68 +126,36 @@ namespace bridge {
 		return parse(max, true);
 	}
 	
-	uint64_t Channel::next(uint8_t width) {
-		uint8_t nbytes = ceil((width - nremainder) / 8.0);
-        read(buffer + 1, nbytes);
-		uint8_t last = buffer[nbytes];
-		shift(buffer, nbytes + 1, nremainder - 8);
-		uint64_t aligned = pack(buffer, nbytes + 1);
-        nremainder = modcom(width - nremainder, 8);
-		buffer[0] = last & rmask(nremainder);
-		return decompress(aligned, 8 * (nbytes + 1), width);
+	// Read a field of up to 32 bits, most significant bit first.
+	uint32_t Channel::next(uint8_t width) {
+		if (nremainder == 0) {
+			// Byte-aligned fields skip the accumulator.
+			if (width == 8) {
+				return read();
+			} else if (width == 16) {
+				uint16_t number = (uint16_t) read() << 8;
+				return number | read();
+			} else if (width == 24) {
+				uint32_t number = (uint32_t) read() << 16;
+				number |= (uint16_t) read() << 8;
+				return number | read();
+			}
+		}
+		if (width > 24) {
+			// Accumulator holds at most 7 pending bits plus 3 bytes.
+			uint32_t number = next(width - 16) << 16;
+			return number | next(16);
+		}
+		while (nremainder < width) {
+			accumulator = (accumulator << 8) | read();
+			nremainder += 8;
+		}
+		nremainder -= width;
+		return (accumulator >> nremainder) & pgm_read_dword(&masks[width]);
 	}
 
 	void Channel::next() {
-		buffer[0] = 0;
+		accumulator = 0;
 		nremainder = 0;
 	}
-
-	// Remainder is on the far right of the returned octect.
-	uint8_t Channel::shift(uint8_t* bytes, uint8_t nbytes, int8_t s) {
-		uint8_t remainder = 0;
-        if (s > 0) {
-            for (int b = 0; b < nbytes; b++) {
-                uint8_t byte = bytes[b];
-                bytes[b] = (bytes[b] >> s) | remainder;
-                remainder = byte << (8 - s);
-            }
-        } else if (s < 0) {
-            s *= -1;
-            for (int b = nbytes - 1; b >= 0; b--) {
-                uint8_t byte = bytes[b];
-                bytes[b] = bytes[b] << s | remainder;
-                remainder = byte >> (8 - s);
-            }
-        }
-		return remainder;
-	}
-
-	// modcom( 5, 8) --> 3
-	// modcom(16, 8) --> 0
-	// Complement of modulus after division, by the same divisor.
-	inline uint8_t Channel::modcom(int8_t x, int8_t k) {
-	    return (k - (x % k)) % k;
-	}
-
-	// Convert an array of bytes to a 64 bit number.
-	uint64_t Channel::pack(uint8_t* bytes, uint8_t nbytes) {
-		// Combine bytes into one number.
-		uint64_t number = 0;
-		for (uint8_t b = 0; b < nbytes; b++)
-			number |= (uint64_t) bytes[b] << 8 * (nbytes - 1 - b);
-		return number;
-	}
-
-	uint64_t Channel::decompress(uint64_t number, uint8_t offset, uint8_t width) {
-		number = (number >> offset - width) & rmask(width);
-		return number;
-	}
-
-	uint64_t Channel::rmask(uint8_t width) {
-	    // The mask will be constructed correctly in both 32- and 64-bit systems as long as the width is less than 32 and 64, respectively.
-		uint64_t mask = 0;
-		for (uint8_t w = 0; w < width; w++)
-			mask = (mask << 1) | 1;
-        return mask;
-	}
 }
\ No newline at end of file
@@ -2,31 +2,34 @@
 #define CHANNEL_H
 
 #include <stdint.h>
-#include "HardwareSerial.h"
+
+/// Max number of bytes a single command may occupy, including its header.
+#define BRIDGE_CHANNEL_SIZE 64
 
 namespace bridge {
 	class Channel {
 		public:
 			Channel();
-			Channel(HardwareSerial* serial);
-			bool available();
-			uint8_t read();								// Block-read one byte from Serial.
-			uint8_t peek();								// Block-peek one byte from Serial.
-			void read(uint8_t* bytes, uint8_t nbytes);	// Read n bytes from Serial into input array.
+			bool push(uint8_t byte);					// Append one byte to the pending command; false if full.
+			void clear();								// Drop the pending command.
+			uint8_t size();								// Number of bytes buffered for the pending command.
+			uint8_t at(uint8_t i);						// Peek at a buffered byte without consuming it.
+			bool available();							// Whether unread bytes remain in the pending command.
+			uint8_t read();								// Read one byte from the pending command.
+			uint8_t peek();								// Peek one byte from the pending command.
+			void read(uint8_t* bytes, uint8_t nbytes);	// Read n bytes from the pending command into input array.
 			uint64_t parse(uint64_t max, bool trim);	// 
 			uint64_t parse(uint64_t max);				// 
-			uint64_t next(uint8_t nbits);				// Read the next n bits from serial (up to 64).
+			uint32_t next(uint8_t nbits);				// Read the next n bits from the pending command (up to 32).
 			void next();								// Drop bits to the right of current byte.
 		
 		private:
-			uint64_t pack(uint8_t* bytes, uint8_t nbits);
-			uint64_t decompress(uint64_t number, uint8_t offset, uint8_t width); // Extract a number from a subset of bits in another number.
-			uint8_t shift(uint8_t* bytes, uint8_t nbytes, int8_t s);
-			uint64_t rmask(uint8_t width);
-			uint8_t modcom(int8_t x, int8_t k);
-			uint8_t nremainder;
-			uint8_t buffer[8 + 1];
-			HardwareSerial* serial;
+			static const uint32_t masks[25];			// Masks for fields of 0 to 24 bits.
+			uint32_t accumulator;						// Bits read from the pending command; the lowest nremainder bits are unread.
+			uint8_t nremainder;							// Number of unread bits in the accumulator.
+			uint8_t frame[BRIDGE_CHANNEL_SIZE];			// Bytes of the command being assembled.
+			uint8_t length;								// Number of bytes in frame.
+			uint8_t position;							// Read carret within frame.
 	};
 }
 
@@ -0,0 +1,117 @@
+#ifndef DEADLINEHEAP_H
+#define DEADLINEHEAP_H
+
+#include <stdint.h>
+
+namespace bridge {
+	/*
+		Binary min-heap of pins keyed by a 32-bit deadline (us).
+		Deadlines are compared relative to each other, which holds across micros() wraps as long as pending deadlines
+		are less than 2^31 us apart. A map from pin to heap position makes rescheduling and removal O(log n).
+	*/
+	template<uint8_t capacity, uint8_t length>
+	class DeadlineHeap {
+		public:
+			static const uint8_t none = 255;
+
+			DeadlineHeap() : count(0) {
+				static_assert(capacity < none, "DeadlineHeap capacity must be lower than 255.");
+				for (uint8_t pin = 0; pin < length; pin++)
+					positions[pin] = none;
+			}
+
+			// Add a pin, or move it if already present.
+			bool schedule(uint8_t pin, uint32_t deadline) {
+				if (pin >= length)
+					return false;
+				uint8_t position = positions[pin];
+				if (position == none) {
+					if (count == capacity)
+						return false;
+					position = count++;
+					pins[position] = pin;
+					positions[pin] = position;
+				}
+				deadlines[position] = deadline;
+				up(position);
+				down(positions[pin]);
+				return true;
+			}
+
+			void remove(uint8_t pin) {
+				if (pin >= length || positions[pin] == none)
+					return;
+				uint8_t position = positions[pin];
+				positions[pin] = none;
+				if (--count != position) {
+					move(count, position);
+					up(position);
+					down(positions[pins[position]]);
+				}
+			}
+
+			// Earliest pin and its deadline, if any.
+			bool top(uint8_t &pin, uint32_t &deadline) {
+				if (count == 0)
+					return false;
+				pin = pins[0];
+				deadline = deadlines[0];
+				return true;
+			}
+
+			uint8_t size() {
+				return count;
+			}
+
+		private:
+			static bool before(uint32_t a, uint32_t b) {
+				return (int32_t) (a - b) < 0;
+			}
+
+			void move(uint8_t from, uint8_t to) {
+				pins[to] = pins[from];
+				deadlines[to] = deadlines[from];
+				positions[pins[to]] = to;
+			}
+
+			void swap(uint8_t a, uint8_t b) {
+				uint8_t pin = pins[a];
+				uint32_t deadline = deadlines[a];
+				move(b, a);
+				pins[b] = pin;
+				deadlines[b] = deadline;
+				positions[pin] = b;
+			}
+
+			void up(uint8_t position) {
+				while (position > 0) {
+					uint8_t parent = (position - 1) / 2;
+					if (!before(deadlines[position], deadlines[parent]))
+						break;
+					swap(position, parent);
+					position = parent;
+				}
+			}
+
+			void down(uint8_t position) {
+				while (true) {
+					uint16_t child = 2 * position + 1;
+					if (child >= count)
+						break;
+					if (child + 1 < count && before(deadlines[child + 1], deadlines[child]))
+						child++;
+					if (!before(deadlines[child], deadlines[position]))
+						break;
+					swap(position, child);
+					position = child;
+				}
+			}
+
+			uint32_t deadlines[capacity];	// Deadline of each heap position.
+			uint8_t pins[capacity];			// Pin at each heap position.
+			uint8_t positions[length];		// Heap position of each pin, none when absent.
+			uint8_t count;					// Number of pins.
+	};
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+
+/// Max number of payload bytes in a frame.
+#define BRIDGE_FRAME_SIZE 48
+
+namespace bridge {
+	/*
+		Frame layout:
+			| sync | length | sequence | payload (length bytes) | crc8 |
+		The CRC-8 (polynomial 0x07) covers length, sequence, and payload.
+	*/
+	class Frame {
+		public:
+			static const uint8_t sync = 0xA5;
+			static const uint8_t overhead = 4;
+			
+			Frame();
+			
+			// Decoding.
+			bool push(uint8_t byte);			// Append a received byte; true when a valid frame is available.
+			bool next();						// Drop the processed frame; true when another valid frame is already buffered.
+			void clear();						// Drop all buffered bytes.
+			uint8_t size();						// Payload length of a valid frame.
+			uint8_t at(uint8_t i);				// Payload byte of a valid frame.
+			uint8_t sequence();					// Sequence number of a valid frame.
+			uint16_t errors;					// Number of frames dropped due to bad length or checksum.
+			
+			// Encoding.
+			void begin(uint8_t sequence);		// Start a frame with the given sequence number.
+			bool add(uint8_t byte);				// Append a payload byte; false if full.
+			uint8_t room();						// Number of payload bytes that can still be added.
+			bool empty();						// Whether no payload has been added.
+			uint8_t finish();					// Close the frame; returns the number of bytes to send.
+			const uint8_t* bytes();				// Encoded frame.
+			
+			static uint8_t crc(uint8_t crc, uint8_t byte);
+			
+		private:
+			static const uint8_t table[256];
+			uint8_t buffer[BRIDGE_FRAME_SIZE + overhead];
+			uint8_t length;
+			bool scan();
+			bool resync();
+	};
+}
+
+#endif
@@ -3,7 +3,7 @@
 #include "types.h"
 
 namespace bridge {
-	GetBinary::GetBinary(int8_t hid, uint64_t debounceRise, uint64_t debounceFall, uint8_t factor) :
+	GetBinary::GetBinary(int8_t hid, uint32_t debounceRise, uint32_t debounceFall, uint8_t factor) :
 	hid(hid),
 	// Initialize debouncing function.
 	debounceRise(debounceRise),
@@ -19,17 +19,24 @@ namespace bridge {
 		
 		// Get current state.
 		state = digitalRead(hid);
+		interruptible = false;
+		changeTic = micros();
+		edgeTic = changeTic;
 	}
 	
 	// Event receiver.
-	void GetBinary::step(uint64_t tic) {
-		step(tic, digitalRead(hid));
+	void GetBinary::step(uint32_t tic) {
+		if (!interruptible)
+			step(tic, digitalRead(hid));
+		else if (debouncingState != 2)
+			// Edges arrive with their own time; accept the last one once its debounce elapsed.
+			step(tic, debouncingState);
 	}
 	
 	/*	step(tic, parameter)
 		parameter == 255 ? <toggle-state> : state = parameter
 	 */
-	void GetBinary::step(uint64_t tic, uint8_t parameter) {
+	void GetBinary::step(uint32_t tic, uint8_t parameter) {
 		uint8_t currentState;
 		if (parameter == 255)
 			currentState = !state;
@@ -48,11 +55,13 @@ namespace bridge {
 			*/
 			debouncingState = currentState;
 			debounceNext = tic + (currentState ? debounceFall : debounceRise);
+			edgeTic = tic;
 		}
 		
-		if (currentState != state && tic >= debounceNext) {
+		if (currentState != state && Timebase::reached(tic, debounceNext)) {
 			// State debounced (accepted).
 			state = currentState;
+			changeTic = edgeTic;
 			// Increment count on change.
 			count[currentState]++;
 		}
@@ -63,19 +72,19 @@ namespace bridge {
 			setup = false;
 			// First report corresponds to current state.
 			int8_t value = state == 1 ? +1 : -1;
-			reportFunction(hid, value, value);
+			setup = reportFunction(hid, Kind::binary, changeTic, value, value) == 0;
 		} else {
-			// Further reports represent actual changes.
+			// Further reports represent actual changes. What was not reported is merged into the next ones.
 			uint64_t countFactored[2] = {(count[0] + factor - 1) / factor, (count[1] + factor - 1) / factor};
 			uint64_t difference[2] = {countFactored[0] - last[0], countFactored[1] - last[1]};
-			last[0] = countFactored[0];
-			last[1] = countFactored[1];
 			if (state) {
-				reportFunction(hid, -countFactored[0], -difference[0]);
-				reportFunction(hid, +countFactored[1], +difference[1]);
+				last[0] -= reportFunction(hid, Kind::binary, changeTic, -countFactored[0], -difference[0]);
+				if (last[0] == countFactored[0])
+					last[1] += reportFunction(hid, Kind::binary, changeTic, +countFactored[1], +difference[1]);
 			} else {
-				reportFunction(hid, +countFactored[1], +difference[1]);
-				reportFunction(hid, -countFactored[0], -difference[0]);
+				last[1] += reportFunction(hid, Kind::binary, changeTic, +countFactored[1], +difference[1]);
+				if (last[1] == countFactored[1])
+					last[0] -= reportFunction(hid, Kind::binary, changeTic, -countFactored[0], -difference[0]);
 			}
 		}
 	}
@@ -83,4 +92,10 @@ namespace bridge {
 	int GetBinary::index() {
 		return hid;
 	}
+	
+	void GetBinary::attached(bool interruptible) {
+		this->interruptible = interruptible;
+		// Edges handed over are accepted right away unless a debounce has to elapse in between.
+		stepped = !interruptible || debounceRise > 0 || debounceFall > 0;
+	}
 }
\ No newline at end of file
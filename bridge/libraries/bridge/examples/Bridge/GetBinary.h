@@ -8,22 +8,28 @@
 namespace bridge {
 	class GetBinary : public Routine {
 		public:
-			GetBinary(int8_t hid, uint64_t debounceRise, uint64_t debounceFall, uint8_t factor);
-			void step(uint64_t tic);
-			void step(uint64_t tic, uint8_t state);
+			static const Type type = Type::getBinary;
+			
+			GetBinary(int8_t hid, uint32_t debounceRise, uint32_t debounceFall, uint8_t factor);
+			void step(uint32_t tic);
+			void step(uint32_t tic, uint8_t state);
 			void report(ReportFunction reportFunction);
 			int index();
+			void attached(bool interruptible);
 			
 		private:
 			bool setup;
+			bool interruptible;			// Whether edges are captured by an interrupt.
 			int8_t hid;					// Active pin.
 			uint64_t count[2]{0};		// Number of counts for each state.
 			uint64_t last[2]{0};
 			uint8_t state;				// Last known pin state.
 			uint8_t debouncingState;	// Debounce state.
-			uint64_t debounceRise;		// Debounce duration from low to high.
-			uint64_t debounceFall;		// Debounce duration from high to low.
-			uint64_t debounceNext;		// Ticker for debounce control.
+			uint32_t debounceRise;		// Debounce duration from low to high.
+			uint32_t debounceFall;		// Debounce duration from high to low.
+			uint32_t debounceNext;		// Ticker for debounce control.
+			uint32_t edgeTic;			// Time of the last edge under debounce.
+			uint32_t changeTic;			// Time of the edge leading to the last accepted change.
 			uint8_t factor;				// 
 	};
 }
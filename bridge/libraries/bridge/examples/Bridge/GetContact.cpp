@@ -13,27 +13,30 @@ namespace bridge {
 	GetContact::GetContact(int8_t hid0, int8_t hid1, uint8_t nPeriods, uint8_t threshold, uint32_t debounceRise, uint32_t debounceFall) : 
 	// Initialize IO.
 	hid0(hid0),
+	touchSensor(hid0, hid1, nPeriods, threshold, debounceRise, debounceFall, GetContact::onChange, (uintptr_t) this),
 	count(0),
 	lastReportedCount(0),
-	lastReportedState(HIGH)
+	lastReportedState(HIGH),
+	changeTic(0)
 	{
-		touchSensor = new TouchSensor(hid0, hid1, nPeriods, threshold, debounceRise, debounceFall, GetContact::onChange, (uintptr_t) this);
 	}
 
 	// Event receiver.
-	void GetContact::step(uint64_t tic) {
-		touchSensor->Step();
+	void GetContact::step(uint32_t tic) {
+		touchSensor.Step();
 	}
 	
 	void GetContact::onChange(TouchSensor* touchSensor, bool state, uintptr_t data) {
 		GetContact* self = (GetContact*) data;
 		self->count += 1;
+		self->changeTic = micros();
 	}
 	
 	void GetContact::report(ReportFunction reportFunction) {
 		// Report on change.
 		while (lastReportedCount < count) {
-			reportFunction(hid0, lastReportedCount, lastReportedState ? -1 : +1);
+			if (reportFunction(hid0, Kind::contact, changeTic, lastReportedCount, lastReportedState ? -1 : +1) == 0)
+				break;
 			lastReportedState = !lastReportedState;
 			lastReportedCount += 1;
 		}
@@ -16,21 +16,24 @@
 namespace bridge {
 	class GetContact : public Routine {
 		public:
+			static const Type type = Type::getContact;
+			
 			GetContact(int8_t hid0, int8_t hid1, uint8_t nPeriods, uint8_t threshold, uint32_t debounceRise, uint32_t debounceFall);
 			//~GetContact();
 			bool test(bool &state);
-			void step(uint64_t tic);
+			void step(uint32_t tic);
 			void report(ReportFunction reportFunction);
 			int index();
 			
 		private:
 			int8_t hid0;				// Active pin. Store it for report purposes.
-			TouchSensor* touchSensor;
+			TouchSensor touchSensor;
 			
 			static void onChange(TouchSensor* touchSensor, bool state, uintptr_t data);
 			uint32_t count;				// Current contact count.
 			bool lastReportedState;		// Last reported state.
 			uint32_t lastReportedCount;	// Last reported count.
+			uint32_t changeTic;			// Time at which the last change was detected.
 	};
 }
 
@@ -3,12 +3,13 @@
 #include "types.h"
 
 namespace bridge {
-	GetLevel::GetLevel(int8_t hid, uint64_t debounceRise, uint64_t debounceFall) :
+	GetLevel::GetLevel(int8_t hid, uint32_t debounceRise, uint32_t debounceFall, AnalogFilter::Type filter, uint8_t parameter, uint16_t deadband) :
 	hid(hid),
 	// Initialize debouncing function.
 	debounceRise(debounceRise),
 	debounceFall(debounceFall),
 	debounceNext(0),
+	deadband(deadband),
 	// Report first state counting from zero, after debouncing.
 	lastState(0),
 	debouncingState(0)
@@ -16,29 +17,48 @@ namespace bridge {
 		// Turn pin into an input.
 		pinMode(hid, INPUT);
 		
-		state = analogRead(hid);
+		// Sampled in the background; wait for the first sample only.
+		this->filter.Setup(filter, parameter);
+		AnalogSampler::Attach(hid);
+		count = AnalogSampler::Count(hid);
+		value = this->filter.Filter(AnalogSampler::Wait(hid));
+		state = value;
+		changeTic = micros();
+		edgeTic = changeTic;
+	}
+	
+	GetLevel::~GetLevel() {
+		AnalogSampler::Detach(hid);
 	}
 
 	// Event receiver.
-	void GetLevel::step(uint64_t tic) {
-		uint8_t state = analogRead(hid);
+	void GetLevel::step(uint32_t tic) {
+		// Filter each sample once.
+		uint8_t count = AnalogSampler::Count(hid);
+		if (count != this->count) {
+			this->count = count;
+			value = filter.Filter(AnalogSampler::Read(hid));
+		}
+		// Changes within the deadband of the accepted value are ignored.
+		uint16_t state = (value > this->state ? value - this->state : this->state - value) > deadband ? value : this->state;
 		
 		// Debounced read.
 		if (state != this->debouncingState) {
 			bool fall = this->state > state;
 			this->debounceNext = tic + (fall ? debounceFall : debounceRise);
 			this->debouncingState = state;
+			this->edgeTic = tic;
 		}
 		
-		if (state != this->state && tic >= debounceNext) {
+		if (state != this->state && Timebase::reached(tic, debounceNext)) {
 			this->state = state;
+			this->changeTic = edgeTic;
 		}
 	}
 	
 	void GetLevel::report(ReportFunction reportFunction) {
 		if (state != lastState)
-			reportFunction(hid, state, state - lastState);
-			lastState = state;
+			lastState += reportFunction(hid, Kind::level, changeTic, state, state - lastState);
 	}
 	
 	int GetLevel::index() {
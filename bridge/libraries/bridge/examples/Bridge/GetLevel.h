@@ -2,25 +2,36 @@
 #define GETLEVEL_H
 
 #include <stdint.h>
+#include "AnalogFilter.h"
+#include "AnalogSampler.h"
 #include "Routine.h"
 #include "types.h"
 
 namespace bridge {
 	class GetLevel : public Routine {
 		public:
-			GetLevel(int8_t hid, uint64_t debounceRise, uint64_t debounceFall);
-			void step(uint64_t tic);
+			static const Type type = Type::getLevel;
+			
+			GetLevel(int8_t hid, uint32_t debounceRise, uint32_t debounceFall, AnalogFilter::Type filter = AnalogFilter::Type::None, uint8_t parameter = 0, uint16_t deadband = 0);
+			~GetLevel();
+			void step(uint32_t tic);
 			void report(ReportFunction reportFunction);
 			int index();
 			
 		private:
 			int8_t hid;					// Active pin.
-			uint8_t state;				// Last known pin state.
-			uint8_t lastState;
-			uint8_t debouncingState;	// Debounce state.
-			uint64_t debounceRise;		// Debounce duration from low to high.
-			uint64_t debounceFall;		// Debounce duration from high to low.
-			uint64_t debounceNext;		// Ticker for debounce control.
+			uint16_t state;				// Last accepted value (10 bits).
+			uint16_t lastState;			// Last reported value.
+			uint16_t value;				// Last filtered sample.
+			uint16_t debouncingState;	// Debounce state.
+			uint16_t deadband;			// Largest change of the filtered value that is ignored.
+			uint8_t count;				// Number of samples of the pin when last filtered.
+			AnalogFilter filter;		// Filter of the samples.
+			uint32_t debounceRise;		// Debounce duration from low to high.
+			uint32_t debounceFall;		// Debounce duration from high to low.
+			uint32_t debounceNext;		// Ticker for debounce control.
+			uint32_t edgeTic;			// Time of the last change under debounce.
+			uint32_t changeTic;			// Time of the change leading to the last accepted value.
 	};
 }
 
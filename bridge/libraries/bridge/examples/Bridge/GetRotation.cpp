@@ -3,52 +3,74 @@
 #include "types.h"
 
 namespace bridge {
-	GetRotation::GetRotation(int8_t hid0, int8_t hid1, uint8_t factor) :
+	GetRotation::GetRotation(int8_t hid0, int8_t hid1, uint8_t factor, bool x4) :
 	hid0(hid0),
 	hid1(hid1),
 	count(0),
 	lastCount(0),
-	factor(factor)
+	changeTic(0),
+	factor(factor),
+	x4(x4)
 	{	
 		// Turn pins into inputs.
 		pinMode(hid0, INPUT_PULLUP);
 		pinMode(hid1, INPUT_PULLUP);
 		
 		this->state0 = digitalRead(hid0);
+		if (x4)
+			decoder = Quadrature(hid0, hid1);
+		interruptible = false;
 	}
 	
-	// Event receiver.
-	void GetRotation::step(uint64_t tic) {
-		step(tic, digitalRead(hid0));
+	// Event receiver: poll pins when their edges are not captured by interrupts.
+	void GetRotation::step(uint32_t tic) {
+		if (x4) {
+			if (!interruptible) {
+				noInterrupts();
+				decoder.Sample();
+				interrupts();
+			}
+			// Edges are decoded as they happen, but timed at the step that sees them.
+			int32_t current = decoder.GetCount();
+			if (current != count) {
+				count = current;
+				changeTic = tic;
+			}
+		} else if (!interruptible) {
+			bool state0 = digitalRead(hid0);
+			if (state0 && !this->state0)
+				step(tic, digitalRead(hid1));
+			this->state0 = state0;
+		}
 	}
 	
-	void GetRotation::step(uint64_t tic, uint8_t parameter) {
-		bool state0;
-		if (parameter == 255) {
-			state0 = true;
-			this->state0 = false;
-		} else {
-			state0 = parameter;
-		}
-		if (state0 && !this->state0) {
-			int8_t delta = digitalRead(hid1) ? +1 : -1;
-			count += delta;
-		}
-		this->state0 = state0;
+	// Rising edge of hid0, with the state of hid1 at that time giving the direction.
+	void GetRotation::step(uint32_t tic, uint8_t state1) {
+		count += state1 ? +1 : -1;
+		changeTic = tic;
 	}
 	
 	void GetRotation::report(ReportFunction reportFunction) {
-		noInterrupts();
-		int64_t copy = count;
-		interrupts();
-		int64_t current = copy / factor;
-		if (lastCount != current) {
-			reportFunction(hid0, copy, current - lastCount);
-			lastCount = current;
-		}
+		int64_t current = count / factor;
+		if (lastCount != current)
+			lastCount += reportFunction(hid0, Kind::rotation, changeTic, count, current - lastCount);
 	}
 	
 	int GetRotation::index() {
 		return hid0;
 	}
+	
+	void GetRotation::attached(bool interruptible) {
+		this->interruptible = interruptible;
+		// The decoder count is read every step; x1 edges are counted as they are handed over.
+		stepped = x4 || !interruptible;
+	}
+	
+	uint16_t GetRotation::errors() {
+		return x4 ? decoder.GetErrors() : 0;
+	}
+	
+	Quadrature* GetRotation::quadrature() {
+		return x4 ? &decoder : nullptr;
+	}
 }
\ No newline at end of file
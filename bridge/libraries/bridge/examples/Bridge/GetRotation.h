@@ -2,24 +2,34 @@
 #define GETROTATION_H
 
 #include <stdint.h>
+#include "Quadrature.h"
 #include "Routine.h"
 #include "types.h"
 
 namespace bridge {
 	class GetRotation : public Routine {
 		public:
-			GetRotation(int8_t hid0, int8_t hid1, uint8_t factor);
-			void step(uint64_t tic);
-			void step(uint64_t tic, uint8_t parameter);
+			static const Type type = Type::getRotation;
+			
+			GetRotation(int8_t hid0, int8_t hid1, uint8_t factor, bool x4 = false);
+			void step(uint32_t tic);
+			void step(uint32_t tic, uint8_t state1);
 			void report(ReportFunction reportFunction);
 			int index();
+			uint16_t errors();
+			void attached(bool interruptible);
+			Quadrature* quadrature();		// Decoder to sample on changes of either pin, in x4 mode.
 			
 		private:
 			bool state0;					// Last known pin state for hid0.
+			bool interruptible;				// Whether edges are captured by interrupts.
+			bool x4;						// Whether both edges of both pins are counted.
+			Quadrature decoder;				// Decoder used in x4 mode.
 			int8_t hid0;					// Active pin.
 			int8_t hid1;					// Passive pin.
 			int64_t count;					// Number of counts for each state.
 			int64_t lastCount;
+			uint32_t changeTic;				// Time of the last step.
 			uint8_t factor;					// 
 	};
 }
@@ -3,44 +3,95 @@
 #include "types.h"
 
 namespace bridge {
-	GetThreshold::GetThreshold(int8_t hid, uint8_t threshold, uint64_t debounceRise, uint64_t debounceFall) :
+	GetThreshold::GetThreshold(int8_t hid, uint16_t low, uint16_t high, uint32_t debounceRise, uint32_t debounceFall, AnalogFilter::Type filter, uint8_t parameter, bool sampled) :
 	hid(hid),
-	threshold(threshold),
+	low(min(low, high)),
+	high(high),
 	// Initialize debouncing function.
 	debounceRise(debounceRise),
 	debounceFall(debounceFall),
 	changes(0),
-	debounceNext(0)
+	sampled(false),
+	started(false)
 	{
 		// Turn pin into an input.
 		pinMode(hid, INPUT);
 		
-		state = analogRead(hid) < threshold;
-		lastState = state;
-		debouncingState = state;
+		this->filter.Setup(filter, parameter);
+		changeTic = micros();
+		edgeTic = changeTic;
+		debounceNext = changeTic;
+		// Otherwise, wait to learn whether the analog comparator serves the pin.
+		if (sampled)
+			attached(false);
+	}
+	
+	GetThreshold::~GetThreshold() {
+		if (sampled)
+			AnalogSampler::Detach(hid);
+	}
+	
+	// Detect crossings with the analog comparator interrupt, else from samples of the ADC.
+	// Called again when the analog comparator hands the pin over to the ADC, keeping the side accepted so far.
+	void GetThreshold::attached(bool interruptible) {
+		bool current;
+		sampled = !interruptible;
+		if (sampled) {
+			// Sampled in the background; wait for the first sample only.
+			AnalogSampler::Attach(hid);
+			count = AnalogSampler::Count(hid);
+			value = filter.Filter(AnalogSampler::Wait(hid));
+			current = value >= high;
+		} else {
+			current = AnalogComparator::Read();
+		}
+		debouncingState = current;
+		if (!started) {
+			// Start on the opposite side, so that the first step reports the current one.
+			started = true;
+			state = !current;
+			lastState = state;
+		}
 	}
 
 	// Event receiver.
-	void GetThreshold::step(uint64_t tic) {
-		bool current = analogRead(hid) >= threshold;
-		
+	void GetThreshold::step(uint32_t tic) {
+		if (!sampled) {
+			// Crossings arrive with their own time; accept the last one once its debounce elapsed.
+			if (debouncingState != state)
+				step(tic, debouncingState);
+			return;
+		}
+		// Filter each sample once.
+		uint8_t count = AnalogSampler::Count(hid);
+		if (count != this->count) {
+			this->count = count;
+			value = filter.Filter(AnalogSampler::Read(hid));
+		}
+		// Hysteresis: above the threshold from high upwards, below it from low downwards, unchanged in between.
+		step(tic, value >= (debouncingState ? low : high));
+	}
+	
+	// Side of the threshold at a given time, from samples or from the analog comparator.
+	void GetThreshold::step(uint32_t tic, uint8_t current) {
 		// Debounced read.
 		if (current != debouncingState) {
 			debounceNext = tic + (state ? debounceFall : debounceRise);
 			debouncingState = current;
+			edgeTic = tic;
 		}
 		
-		if (current != state && tic >= debounceNext) {
+		if (current != state && Timebase::reached(tic, debounceNext)) {
 			state = current;
+			changeTic = edgeTic;
 			changes++;
 		}
 	}
 	
 	void GetThreshold::report(ReportFunction reportFunction) {
-		while (changes > 0) {
+		while (changes > 0 && reportFunction(hid, Kind::threshold, changeTic, !lastState, lastState ? -1 : 1) != 0) {
 			changes -= 1;
 			lastState = !lastState;
-			reportFunction(hid, lastState, lastState ? 1 : -1);
 		}
 	}
 	
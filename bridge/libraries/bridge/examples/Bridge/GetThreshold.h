@@ -2,27 +2,43 @@
 #define GETTRESHOLD_H
 
 #include <stdint.h>
+#include "AnalogComparator.h"
+#include "AnalogFilter.h"
+#include "AnalogSampler.h"
 #include "Routine.h"
 #include "types.h"
 
 namespace bridge {
 	class GetThreshold : public Routine {
 		public:
-			GetThreshold(int8_t hid, uint8_t threshold, uint64_t debounceRise, uint64_t debounceFall);
-			void step(uint64_t tic);
+			static const Type type = Type::getThreshold;
+			
+			GetThreshold(int8_t hid, uint16_t low, uint16_t high, uint32_t debounceRise, uint32_t debounceFall, AnalogFilter::Type filter = AnalogFilter::Type::None, uint8_t parameter = 0, bool sampled = true);
+			~GetThreshold();
+			void step(uint32_t tic);
+			void step(uint32_t tic, uint8_t current);
+			void attached(bool interruptible);
 			void report(ReportFunction reportFunction);
 			int index();
 			
 		private:
 			int8_t hid;				// Active pin.
-			uint8_t threshold;		// Threshold to toggle state.
+			uint16_t low;			// Threshold crossed downwards when the value drops below it.
+			uint16_t high;			// Threshold crossed upwards when the value reaches it.
 			int32_t changes;
 			bool state;				// Last known pin state.
 			bool lastState;			// 
 			bool debouncingState;	// Debounce state.
-			uint64_t debounceRise;	// Debounce duration from low to high.
-			uint64_t debounceFall;	// Debounce duration from high to low.
-			uint64_t debounceNext;	// Ticker for debounce control.
+			bool sampled;			// Whether crossings are detected from samples of the ADC, rather than by the analog comparator.
+			bool started;			// Whether the side of the threshold was taken, in a first call to attached.
+			uint8_t count;			// Number of samples of the pin when last filtered.
+			uint16_t value;			// Last filtered sample.
+			AnalogFilter filter;	// Filter of the samples.
+			uint32_t debounceRise;	// Debounce duration from low to high.
+			uint32_t debounceFall;	// Debounce duration from high to low.
+			uint32_t debounceNext;	// Ticker for debounce control.
+			uint32_t edgeTic;		// Time of the last crossing under debounce.
+			uint32_t changeTic;		// Time of the crossing leading to the last accepted change.
 	};
 }
 
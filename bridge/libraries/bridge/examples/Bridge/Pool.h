@@ -0,0 +1,44 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdint.h>
+#include <new.h>
+
+namespace bridge {
+	/*
+		Fixed number of objects of one type in static storage.
+		Objects are constructed in place and their slots are reused once destroyed, hence the heap is never touched.
+	*/
+	template<typename T, uint8_t capacity>
+	class Pool {
+		public:
+			Pool() {
+				static_assert(capacity > 0, "Pool capacity must be at least 1.");
+				for (uint8_t i = 0; i < capacity; i++)
+					used[i] = false;
+			}
+			
+			// Construct an object in a free slot; nullptr when all slots are in use.
+			template<typename... Args>
+			T* create(Args... args) {
+				for (uint8_t i = 0; i < capacity; i++) {
+					if (!used[i]) {
+						used[i] = true;
+						return new (storage[i]) T(args...);
+					}
+				}
+				return nullptr;
+			}
+			
+			void destroy(T* object) {
+				object->~T();
+				used[((uint8_t*) object - storage[0]) / sizeof(T)] = false;
+			}
+			
+		private:
+			alignas(T) uint8_t storage[capacity][sizeof(T)];
+			bool used[capacity];
+	};
+}
+
+#endif
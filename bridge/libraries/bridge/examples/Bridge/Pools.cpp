@@ -0,0 +1,12 @@
+#include "Pools.h"
+
+namespace bridge {
+	Pool<GetBinary, BRIDGE_POOLS_GETBINARY> Pools::getBinary;
+	Pool<GetContact, BRIDGE_POOLS_GETCONTACT> Pools::getContact;
+	Pool<GetLevel, BRIDGE_POOLS_GETLEVEL> Pools::getLevel;
+	Pool<GetRotation, BRIDGE_POOLS_GETROTATION> Pools::getRotation;
+	Pool<GetThreshold, BRIDGE_POOLS_GETTHRESHOLD> Pools::getThreshold;
+	Pool<SetChirp, BRIDGE_POOLS_SETCHIRP> Pools::setChirp;
+	Pool<SetPulse, BRIDGE_POOLS_SETPULSE> Pools::setPulse;
+	Pool<SetSequence, BRIDGE_POOLS_SETSEQUENCE> Pools::setSequence;
+}
@@ -0,0 +1,51 @@
+#ifndef POOLS_H
+#define POOLS_H
+
+#include <stdint.h>
+#include "GetBinary.h"
+#include "GetContact.h"
+#include "GetLevel.h"
+#include "GetRotation.h"
+#include "GetThreshold.h"
+#include "Pool.h"
+#include "SetChirp.h"
+#include "SetPulse.h"
+#include "SetSequence.h"
+
+/// Number of routines of each type that may exist at once.
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+	#define BRIDGE_POOLS_GETBINARY		8
+	#define BRIDGE_POOLS_GETCONTACT		2
+	#define BRIDGE_POOLS_GETLEVEL		4
+	#define BRIDGE_POOLS_GETROTATION	4
+	#define BRIDGE_POOLS_GETTHRESHOLD	4
+	#define BRIDGE_POOLS_SETCHIRP		2
+	#define BRIDGE_POOLS_SETPULSE		12
+	#define BRIDGE_POOLS_SETSEQUENCE	4
+#else
+	#define BRIDGE_POOLS_GETBINARY		2
+	#define BRIDGE_POOLS_GETCONTACT		1
+	#define BRIDGE_POOLS_GETLEVEL		1
+	#define BRIDGE_POOLS_GETROTATION	1
+	#define BRIDGE_POOLS_GETTHRESHOLD	1
+	#define BRIDGE_POOLS_SETCHIRP		1
+	#define BRIDGE_POOLS_SETPULSE		2
+	#define BRIDGE_POOLS_SETSEQUENCE	1
+#endif
+
+namespace bridge {
+	// Storage of every setter and getter, sized per board (standard or mega variant).
+	class Pools {
+		public:
+			static Pool<GetBinary, BRIDGE_POOLS_GETBINARY> getBinary;
+			static Pool<GetContact, BRIDGE_POOLS_GETCONTACT> getContact;
+			static Pool<GetLevel, BRIDGE_POOLS_GETLEVEL> getLevel;
+			static Pool<GetRotation, BRIDGE_POOLS_GETROTATION> getRotation;
+			static Pool<GetThreshold, BRIDGE_POOLS_GETTHRESHOLD> getThreshold;
+			static Pool<SetChirp, BRIDGE_POOLS_SETCHIRP> setChirp;
+			static Pool<SetPulse, BRIDGE_POOLS_SETPULSE> setPulse;
+			static Pool<SetSequence, BRIDGE_POOLS_SETSEQUENCE> setSequence;
+	};
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <Arduino.h>
+#include "Queue.h"
+
+namespace bridge {
+	Queue::Queue() : policy(Policy::drop), overflows{0}, rings{}, writing(false), overflow(false), writeClass(0), length(0), readClass(0), remaining(0) {
+	}
+	
+	uint8_t Queue::wrap(uint16_t position) {
+		return position >= BRIDGE_QUEUE_SIZE ? position - BRIDGE_QUEUE_SIZE : position;
+	}
+	
+	void Queue::open(Priority priority) {
+		writing = true;
+		overflow = false;
+		writeClass = (uint8_t) priority;
+		length = 0;
+	}
+	
+	bool Queue::close() {
+		if (!writing)
+			return true;
+		writing = false;
+		Ring& ring = rings[writeClass];
+		if (overflow) {
+			if (overflows[writeClass] < 0xFFFF)
+				overflows[writeClass]++;
+			return false;
+		} else if (length > 0) {
+			// Commit the record by writing its length ahead of the bytes already in place.
+			ring.buffer[wrap(ring.head + ring.count)] = length;
+			ring.count += 1 + length;
+		}
+		return true;
+	}
+	
+	// Append to the open record. Without an open record, each call is an event record on its own.
+	size_t Queue::write(uint8_t byte) {
+		return write(&byte, 1);
+	}
+	
+	size_t Queue::write(const uint8_t* bytes, size_t size) {
+		bool implicit = !writing;
+		if (implicit)
+			open(Priority::event);
+		Ring& ring = rings[writeClass];
+		for (size_t i = 0; i < size; i++) {
+			if (ring.count + 1 + length < BRIDGE_QUEUE_SIZE && length < 255) {
+				ring.buffer[wrap(ring.head + ring.count + 1 + length)] = bytes[i];
+				length++;
+			} else {
+				overflow = true;
+				if (length < 255)
+					length++;
+			}
+		}
+		if (implicit)
+			close();
+		return size;
+	}
+	
+	uint8_t Queue::pending() {
+		if (remaining == 0) {
+			// Start the next record, favoring classes in order of priority.
+			for (readClass = 0; readClass < nClasses; readClass++) {
+				Ring& ring = rings[readClass];
+				if (ring.count > 0) {
+					remaining = ring.buffer[ring.head];
+					ring.head = wrap(ring.head + 1);
+					ring.count--;
+					break;
+				}
+			}
+		}
+		return remaining;
+	}
+	
+	bool Queue::pop(uint8_t& byte) {
+		if (pending() == 0)
+			return false;
+		Ring& ring = rings[readClass];
+		byte = ring.buffer[ring.head];
+		ring.head = wrap(ring.head + 1);
+		ring.count--;
+		remaining--;
+		return true;
+	}
+	
+	uint8_t Queue::occupancy(Priority priority) {
+		return (uint16_t) rings[(uint8_t) priority].count * 255 / BRIDGE_QUEUE_SIZE;
+	}
+}
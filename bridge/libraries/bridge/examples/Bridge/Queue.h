@@ -0,0 +1,68 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <stdint.h>
+#include "Print.h"
+
+/// Number of bytes buffered per priority class (up to 255), including one length byte per record.
+#ifndef BRIDGE_QUEUE_SIZE
+#define BRIDGE_QUEUE_SIZE 128
+#endif
+
+namespace bridge {
+	/*
+		Transmission queue drained into the serial port without blocking.
+		Bytes are grouped in records (e.g. one report) which are stored and sent whole.
+		Records of the event class are sent ahead of records of the bulk class, but a record is never interrupted.
+	*/
+	class Queue : public Print {
+		public:
+			enum class Priority : uint8_t {
+				event,		///< Discrete events (binary, contact, threshold) and replies.
+				bulk		///< Streams (level, rotation).
+			};
+			
+			enum class Policy : uint8_t {
+				drop,		///< A record that does not fit is given up by its producer.
+				coalesce	///< A record that does not fit is kept by its producer and merged with the next one.
+			};
+			
+			static const uint8_t nClasses = 2;
+			
+			Queue();
+			
+			// Producer.
+			void open(Priority priority);		// Start a record in the given class.
+			bool close();						// Store the record; false when it did not fit and was discarded.
+			size_t write(uint8_t byte) override;
+			size_t write(const uint8_t* bytes, size_t size) override;
+			
+			// Consumer.
+			uint8_t pending();					// Bytes left in the record being sent, or size of the next record.
+			bool pop(uint8_t& byte);			// Next byte to send, if any.
+			uint8_t occupancy(Priority priority);	// Fraction of the class buffer in use, from 0 to 255.
+			
+			Policy policy;
+			uint16_t overflows[nClasses];		// Number of records dropped or refused per class.
+			
+		private:
+			struct Ring {
+				uint8_t buffer[BRIDGE_QUEUE_SIZE];
+				uint8_t head;					// Position of the next byte to send.
+				uint8_t count;					// Number of bytes stored.
+			};
+			Ring rings[nClasses];
+			
+			bool writing;						// Whether a record is open.
+			bool overflow;						// Whether the open record ran out of room.
+			uint8_t writeClass;
+			uint8_t length;						// Length of the open record.
+			
+			uint8_t readClass;
+			uint8_t remaining;					// Bytes left in the record being sent.
+			
+			static uint8_t wrap(uint16_t position);
+	};
+}
+
+#endif
@@ -2,29 +2,32 @@
 #define ROUTINE_H
 
 #include <stdint.h>
+#include "Timebase.h"
 #include "types.h"
 
 namespace bridge {
+	// Tag of each routine stored in a RoutineTable, which dispatches on it instead of virtual calls.
+	enum class Type : uint8_t {getBinary, getContact, getLevel, getRotation, getThreshold, setChirp, setPulse, setSequence};
+	
+	// State shared by all routines. Methods (step, report, stop, ...) are defined by each routine and called by type.
 	class Routine {
 		public:
-			virtual void report(ReportFunction reportFunction) {
-			}
-			
-			virtual void step() {
-			}
+			static const uint32_t idle = 0x7FFFFFFF;	// Longest wait (us) between steps of a setter, within the range of Timebase::reached.
 			
-			virtual void step(uint64_t tic) {
+			// Deadline of a step due at next; due now when next passed.
+			static uint32_t until(uint32_t tic, uint32_t next) {
+				return Timebase::reached(tic, next) ? tic : next;
 			}
 			
-			virtual void step(uint64_t tic, uint8_t parameter) {
+			// Deadline after a wait, bounded to idle; longer waits take several steps.
+			static uint32_t after(uint32_t tic, uint64_t wait) {
+				return tic + (wait < idle ? (uint32_t) wait : idle);
 			}
 			
-			virtual void stop() {
-			}
-			
-			virtual int index() {
-				return -1;
-			}
+			uint32_t deadline{0};			// Time (us) at which a setter needs its next step.
+			uint32_t reportInterval{0};		// Minimum time (us) between reports; 0 defers to the global interval.
+			uint32_t reportTic{0};			// Time of the last report.
+			bool stepped{true};				// Whether step(tic) is called on every Step; set once the getter knows how its edges arrive.
 	};
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,190 @@
+#ifndef ROUTINETABLE_H
+#define ROUTINETABLE_H
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "GetBinary.h"
+#include "GetContact.h"
+#include "GetLevel.h"
+#include "GetRotation.h"
+#include "GetThreshold.h"
+#include "Pools.h"
+#include "Routine.h"
+#include "SetChirp.h"
+#include "SetPulse.h"
+#include "SetSequence.h"
+#include "types.h"
+
+namespace bridge {
+	/*
+		Fixed-capacity table of routines indexed by pin.
+		Entries are kept contiguous: adding appends, removing moves the last entry into the hole, hence both are O(1) and
+		iterating does not chase pointers. Each entry carries the type of its routine, which selects the method called
+		with a switch rather than a virtual call.
+		Entries are published and retired with interrupts disabled, so an interrupt service routine may look them up
+		while the main loop adds or removes routines; a retired routine is stopped and destroyed only once unreachable.
+	*/
+	template<uint8_t capacity, uint8_t length>
+	class RoutineTable {
+		public:
+			static const uint8_t none = 255;
+
+			RoutineTable() : count(0) {
+				static_assert(capacity < none, "RoutineTable capacity must be lower than 255.");
+				for (uint8_t pin = 0; pin < length; pin++)
+					slots[pin] = none;
+			}
+
+			// Take ownership of a routine for a pin, created from its pool; it is destroyed when the pin is out of range or the table is full.
+			template<typename T>
+			bool set(uint8_t pin, T* routine) {
+				if (!routine)
+					return false;
+				if (pin >= length || (slots[pin] == none && count == capacity)) {
+					destroy(routine, T::type);
+					return false;
+				}
+				unset(pin);
+				uint8_t index = count;
+				routines[index] = routine;
+				types[index] = T::type;
+				pins[index] = pin;
+				noInterrupts();
+				slots[pin] = index;
+				count = index + 1;
+				interrupts();
+				return true;
+			}
+
+			// Stop the routine of a pin, if any, and return it to its pool.
+			bool unset(uint8_t pin) {
+				uint8_t index;
+				if (!find(pin, index))
+					return false;
+				Routine* routine = routines[index];
+				Type type = types[index];
+				uint8_t last = count - 1;
+				noInterrupts();
+				routines[index] = routines[last];
+				types[index] = types[last];
+				pins[index] = pins[last];
+				slots[pins[index]] = index;
+				slots[pin] = none;
+				count = last;
+				interrupts();
+				stop(routine, type);
+				destroy(routine, type);
+				return true;
+			}
+
+			bool find(uint8_t pin, uint8_t &index) {
+				index = pin < length ? slots[pin] : none;
+				return index != none;
+			}
+
+			bool get(uint8_t pin, Routine* &routine) {
+				uint8_t index;
+				if (find(pin, index)) {
+					routine = routines[index];
+					return true;
+				} else {
+					return false;
+				}
+			}
+
+			uint8_t size() {
+				return count;
+			}
+
+			Routine* at(uint8_t index) {
+				return routines[index];
+			}
+
+			// Step a routine; setters also return whether they are still running, after setting their next deadline.
+			bool step(uint8_t index, uint32_t tic) {
+				Routine* routine = routines[index];
+				switch (types[index]) {
+					case Type::getBinary:		static_cast<GetBinary*>(routine)->step(tic); return true;
+					case Type::getContact:		static_cast<GetContact*>(routine)->step(tic); return true;
+					case Type::getLevel:		static_cast<GetLevel*>(routine)->step(tic); return true;
+					case Type::getRotation:		static_cast<GetRotation*>(routine)->step(tic); return true;
+					case Type::getThreshold:	static_cast<GetThreshold*>(routine)->step(tic); return true;
+					case Type::setChirp:		return static_cast<SetChirp*>(routine)->step(tic);
+					case Type::setPulse:		return static_cast<SetPulse*>(routine)->step(tic);
+					case Type::setSequence:		return static_cast<SetSequence*>(routine)->step(tic);
+				}
+				return true;
+			}
+
+			// Edge handed over to a getter, with the state of its sample pin.
+			void step(uint8_t index, uint32_t tic, uint8_t parameter) {
+				Routine* routine = routines[index];
+				switch (types[index]) {
+					case Type::getBinary:		static_cast<GetBinary*>(routine)->step(tic, parameter); break;
+					case Type::getRotation:		static_cast<GetRotation*>(routine)->step(tic, parameter); break;
+					case Type::getThreshold:	static_cast<GetThreshold*>(routine)->step(tic, parameter); break;
+					default: break;
+				}
+			}
+
+			void report(uint8_t index, ReportFunction reportFunction) {
+				Routine* routine = routines[index];
+				switch (types[index]) {
+					case Type::getBinary:		static_cast<GetBinary*>(routine)->report(reportFunction); break;
+					case Type::getContact:		static_cast<GetContact*>(routine)->report(reportFunction); break;
+					case Type::getLevel:		static_cast<GetLevel*>(routine)->report(reportFunction); break;
+					case Type::getRotation:		static_cast<GetRotation*>(routine)->report(reportFunction); break;
+					case Type::getThreshold:	static_cast<GetThreshold*>(routine)->report(reportFunction); break;
+					default: break;
+				}
+			}
+
+			uint16_t errors(uint8_t index) {
+				if (types[index] == Type::getRotation)
+					return static_cast<GetRotation*>(routines[index])->errors();
+				else
+					return 0;
+			}
+
+			void attached(uint8_t index, bool interruptible) {
+				Routine* routine = routines[index];
+				switch (types[index]) {
+					case Type::getBinary:		static_cast<GetBinary*>(routine)->attached(interruptible); break;
+					case Type::getRotation:		static_cast<GetRotation*>(routine)->attached(interruptible); break;
+					case Type::getThreshold:	static_cast<GetThreshold*>(routine)->attached(interruptible); break;
+					default: break;
+				}
+			}
+
+		private:
+			static void stop(Routine* routine, Type type) {
+				switch (type) {
+					case Type::setChirp:		static_cast<SetChirp*>(routine)->stop(); break;
+					case Type::setPulse:		static_cast<SetPulse*>(routine)->stop(); break;
+					case Type::setSequence:		static_cast<SetSequence*>(routine)->stop(); break;
+					default: break;
+				}
+			}
+
+			static void destroy(Routine* routine, Type type) {
+				switch (type) {
+					case Type::getBinary:		Pools::getBinary.destroy(static_cast<GetBinary*>(routine)); break;
+					case Type::getContact:		Pools::getContact.destroy(static_cast<GetContact*>(routine)); break;
+					case Type::getLevel:		Pools::getLevel.destroy(static_cast<GetLevel*>(routine)); break;
+					case Type::getRotation:		Pools::getRotation.destroy(static_cast<GetRotation*>(routine)); break;
+					case Type::getThreshold:	Pools::getThreshold.destroy(static_cast<GetThreshold*>(routine)); break;
+					case Type::setChirp:		Pools::setChirp.destroy(static_cast<SetChirp*>(routine)); break;
+					case Type::setPulse:		Pools::setPulse.destroy(static_cast<SetPulse*>(routine)); break;
+					case Type::setSequence:		Pools::setSequence.destroy(static_cast<SetSequence*>(routine)); break;
+				}
+			}
+
+			Routine* routines[capacity];	// Routines, contiguous from 0 to count - 1.
+			Type types[capacity];			// Type of each routine.
+			uint8_t pins[capacity];			// Pin of each routine.
+			uint8_t slots[length];			// Index of the routine of each pin, none when unused.
+			uint8_t count;					// Number of routines.
+	};
+}
+
+#endif
@@ -7,72 +7,68 @@ namespace bridge {
 	SetChirp::SetChirp() {
 	}
 	
-	SetChirp::SetChirp(int8_t hid, uint64_t durationLowStart, uint64_t durationLowStop, uint64_t durationHighStart, uint64_t durationHighStop, uint64_t duration) :
+	SetChirp::SetChirp(int8_t hid, uint32_t durationLowStart, uint32_t durationLowStop, uint32_t durationHighStart, uint32_t durationHighStop, uint32_t duration, Chirp::Shape shape) :
 	hid(hid),
-	durationLowStart(durationLowStart),
-	durationLowStop(durationLowStop),
-	durationHighStart(durationHighStart),
-	durationHighStop(durationHighStop),
+	duration(duration),
 	
 	starting(true),
 	running(true),
-	fixing(true)
+	channel(-1)
 	{
 		pinMode(hid, OUTPUT);
 		this->state = digitalRead(hid);
-		
-		duration = max(duration, 1);
-		if (durationLowStart < durationLowStop) {
-			slopeLow = durationLowStop - durationLowStart;
-		} else {
-			slopeLow = durationLowStart - durationLowStop;
-			slopeLow *= -1;
-		}
-		slopeLow /= duration;
-		
-		if (durationHighStart < durationHighStop) {
-			slopeHigh = durationHighStop - durationHighStart;
-		} else {
-			slopeHigh = durationHighStart - durationHighStop;
-			slopeHigh *= -1;
-		}
-		slopeHigh /= duration;
-		this->duration = duration;
+		chirp.Setup(durationLowStart, durationLowStop, durationHighStart, durationHighStop, duration, shape);
+		// Widths stay between their start and stop values.
+		uint32_t widest = max(max(durationLowStart, durationLowStop), max(durationHighStart, durationHighStop));
+		schedulable = widest <= EdgeScheduler::maxWidth;
 	}
 	
-	// Event receiver.
-	void SetChirp::step(uint64_t tic) {
+	// Event receiver. Sets the deadline of the next step and returns whether the routine is still running.
+	bool SetChirp::step(uint32_t tic) {
 		// Check phase of the square wave.
 		if (starting) {
 			// Initialize.
 			starting = false;
 			// Schedule next phase change.
-			ticStart = tic;
-			uint64_t width = state ? durationHighStart : durationLowStart;
-			this->tic = tic + width;
-		} else if (running && tic >= this->tic) {
+			uint32_t first = chirp.Next(state);
+			// Let the timer toggle the pin when widths fit; otherwise toggle it from here.
+			if (schedulable)
+				channel = EdgeScheduler::Start(hid, state, first, onEdge, (EdgeScheduler::Data) this);
+			// With the timer, wake up by the end of the chirp.
+			this->tic = channel < 0 ? tic + first : after(tic, duration);
+		} else if (channel >= 0) {
+			// Edges are written by the timer; check again shortly if the last one is late.
+			if (running && Timebase::reached(tic, this->tic))
+				this->tic = tic + 1000;
+		} else if (running && Timebase::reached(tic, this->tic)) {
 			// Flip state.
 			write(!state);
-			// Schedule next phase change.
-			uint64_t elapsed = tic - ticStart;
-			uint64_t width = state ? durationHighStart + slopeHigh * elapsed : durationLowStart + slopeLow * elapsed;
-			this->tic = tic + width;
-			if (elapsed > duration)
+			// Schedule next phase change, relative to the ideal time of this one.
+			uint32_t width = chirp.Next(state);
+			if (width == 0)
 				running = false;
+			else
+				this->tic += width;
 		}
-		// else if (fixing && tic >= this->tic) {
-			// // Flip state.
-			// write(!state);
-			// // Schedule next phase change.
-			// uint64_t width = state ? durationHighStop : durationLowStop;
-			// this->tic = tic + width;
-		// }
+		deadline = until(tic, this->tic);
+		return running;
+	}
+	
+	// Edge written by the scheduler; runs in the interrupt context.
+	uint32_t SetChirp::onEdge(EdgeScheduler::Data data, bool state) {
+		SetChirp* self = (SetChirp*) data;
+		self->state = state;
+		uint32_t width = self->chirp.Next(state);
+		if (width == 0)
+			self->running = false;
+		return width;
 	}
 	
 	void SetChirp::stop() {
+		EdgeScheduler::Stop(channel);
+		channel = -1;
 		// Disable routine.
 		running = false;
-		fixing = false;
 	}
 	
 	// Set state and stop any schedule.
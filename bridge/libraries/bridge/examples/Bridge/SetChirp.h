@@ -2,33 +2,33 @@
 #define SETCHIRP_H
 
 #include <stdint.h>
+#include "Chirp.h"
+#include "EdgeScheduler.h"
 #include "Routine.h"
 
 namespace bridge {
 	class SetChirp : public Routine {
 		public:
+			static const Type type = Type::setChirp;
+			
 			SetChirp();
-			SetChirp(int8_t hid, uint64_t durationLowStart, uint64_t durationLowStop, uint64_t durationHighStart, uint64_t durationHighStop, uint64_t duration);
-			void step(uint64_t tic);
+			SetChirp(int8_t hid, uint32_t durationLowStart, uint32_t durationLowStop, uint32_t durationHighStart, uint32_t durationHighStop, uint32_t duration, Chirp::Shape shape = Chirp::Shape::Linear);
+			bool step(uint32_t tic);
 			int index();
+			void stop();
 			
 		private:
 			int8_t hid;					// Pin id in hardware.
 			bool state;					// Last state.
 			bool starting;				// Whether ticker will start with the next step.
 			volatile bool running;		// Whether the routine is executing.
-			volatile bool fixing;		// 
-			uint64_t ticStart;			// 
-			uint64_t tic;				// Next scheduled phase change.
-			double slopeLow;
-			double slopeHigh;
-			uint64_t durationLowStart;	// Duration of low phase.
-			uint64_t durationLowStop;	// 
-			uint64_t durationHighStart;	// Duration of high phase.
-			uint64_t durationHighStop;	// 
-			uint64_t duration;			// Phase control.
+			bool schedulable;			// Whether all widths fit the scheduler.
+			uint32_t tic;				// Next scheduled phase change.
+			uint32_t duration;			// Duration of the sweep.
+			Chirp chirp;				// Width of each phase.
+			int8_t channel;				// Scheduler channel toggling the pin, if any.
 			void write(bool state);
-			void stop();
+			static uint32_t onEdge(EdgeScheduler::Data data, bool state);
 	};
 }
 
@@ -5,40 +5,83 @@ namespace bridge {
 	SetPulse::SetPulse() {
 	}
 	
-	SetPulse::SetPulse(int8_t hid, bool stateStart, uint64_t durationLow, uint64_t durationHigh, uint64_t repetitions) :
+	SetPulse::SetPulse(int8_t hid, bool stateStart, uint32_t durationLow, uint32_t durationHigh, uint32_t repetitions) :
 	hid(hid),
 	state(stateStart),
 	stateStart(stateStart),
-	durationLow(durationLow),
-	durationHigh(durationHigh),
+	// Phases are scheduled with 32-bit tics.
+	durationLow(min(durationLow, idle)),
+	durationHigh(min(durationHigh, idle)),
 	repetitions(repetitions),
 	
 	tic(0),
 	finite(repetitions > 0),
 	// Start in sync with a period.
 	starting(true),
-	running(true)
+	running(true),
+	channel(-1),
+	generator(-1)
 	{
 		pinMode(hid, OUTPUT);
 	}
 
-	// Event receiver.
-	void SetPulse::step(uint64_t tic) {
+	// Event receiver. Sets the deadline of the next step and returns whether the routine is still running.
+	bool SetPulse::step(uint32_t tic) {
 		// Check phase of the square wave.
 		if (starting) {
 			// Initialize.
 			starting = false;
 			write(stateStart);
-			// Schedule next phase change.
-			this->tic = tic + (stateStart ? durationHigh : durationLow);
-		} else if (running && tic >= this->tic) {
+			// Let a timer generate the pulses when the pin is wired to one, else let the scheduler toggle the pin when durations fit; otherwise toggle it from here.
+			uint32_t width = stateStart ? durationHigh : durationLow;
+			uint32_t widthEnd = stateStart ? durationLow : durationHigh;
+			if (width <= PulseGenerator::maxPeriod && widthEnd <= PulseGenerator::maxPeriod)
+				generator = PulseGenerator::Start(hid, stateStart, width, widthEnd, repetitions);
+			if (generator < 0 && durationLow > 0 && durationHigh > 0 && durationLow <= EdgeScheduler::maxWidth && durationHigh <= EdgeScheduler::maxWidth)
+				channel = EdgeScheduler::Start(hid, stateStart, width, onEdge, (EdgeScheduler::Data) this);
+			if (generator < 0 && channel < 0) {
+				// Schedule next phase change.
+				this->tic = tic + width;
+			} else {
+				// Wake up by the end of the last repetition, which may be beyond the range of a tic.
+				end = finite ? Timebase::epoch() + (uint64_t) repetitions * (durationLow + durationHigh) : (uint64_t) -1;
+				this->tic = wake(tic);
+			}
+		} else if (generator >= 0 || channel >= 0) {
+			// Edges are written by a timer; check again shortly if the last one is late.
+			if (generator >= 0 && !PulseGenerator::IsRunning(generator))
+				running = false;
+			else if (running && Timebase::reached(tic, this->tic))
+				this->tic = wake(tic);
+		} else if (running && Timebase::reached(tic, this->tic)) {
 			// Write opposite state.
 			write(!state);
 			// A phase is completed at stateEnd
 			if (finite && state != stateStart && --repetitions == 0)
 				running = false;
-			this->tic = tic + (state ? durationHigh : durationLow);
+			// Next phase change is relative to the ideal time of this one.
+			this->tic += state ? durationHigh : durationLow;
+		}
+		deadline = until(tic, this->tic);
+		return running;
+	}
+	
+	// Next check of a train written by a timer: by its end, or shortly if the last edge is late.
+	uint32_t SetPulse::wake(uint32_t tic) {
+		uint64_t epoch = Timebase::epoch();
+		return epoch < end ? after(tic, end - epoch) : tic + 1000;
+	}
+	
+	// Edge written by the scheduler; runs in the interrupt context.
+	uint32_t SetPulse::onEdge(EdgeScheduler::Data data, bool state) {
+		SetPulse* self = (SetPulse*) data;
+		self->state = state;
+		// A phase is completed at stateEnd
+		if (self->finite && state != self->stateStart && --self->repetitions == 0) {
+			self->running = false;
+			return 0;
 		}
+		return state ? self->durationHigh : self->durationLow;
 	}
 	
 	// Set state and stop any schedule.
@@ -49,6 +92,10 @@ namespace bridge {
 	
 	void SetPulse::stop() {
 		// Disable routine.
+		EdgeScheduler::Stop(channel);
+		channel = -1;
+		PulseGenerator::Stop(generator);
+		generator = -1;
 		running = false;
 	}
 	
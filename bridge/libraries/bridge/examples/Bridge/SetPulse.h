@@ -2,29 +2,38 @@
 #define SETPULSE_H
 
 #include <stdint.h>
+#include "EdgeScheduler.h"
+#include "PulseGenerator.h"
 #include "Routine.h"
 
 namespace bridge {
 	class SetPulse : public Routine {
 		public:
+			static const Type type = Type::setPulse;
+			
 			SetPulse();
-			SetPulse(int8_t hid, bool stateStart, uint64_t durationLow, uint64_t durationHigh, uint64_t repetitions);
-			void step(uint64_t tic);
+			SetPulse(int8_t hid, bool stateStart, uint32_t durationLow, uint32_t durationHigh, uint32_t repetitions);
+			bool step(uint32_t tic);
 			int index();
+			void stop();
 			
 		private:
 			int8_t hid;					// Pin id in hardware.
 			bool starting;				// Whether ticker will start with the next step.
-			bool running;				// Whether the routine is executing.
+			volatile bool running;		// Whether the routine is executing.
 			bool finite;				// Whether the number of repetitions is finite.
 			bool state;					// Last known state.
 			bool stateStart;			// Make this the first state.
-			uint64_t tic;				// Next scheduled phase change.
-			uint64_t durationLow;		// Duration of low phase.
-			uint64_t durationHigh;		// Duration of high phase.
-			uint64_t repetitions;		// Phase control.
+			uint32_t tic;				// Next scheduled phase change.
+			uint64_t end;				// Epoch at which edges written by a timer end.
+			uint32_t durationLow;		// Duration of low phase.
+			uint32_t durationHigh;		// Duration of high phase.
+			uint32_t repetitions;		// Phase control.
+			int8_t channel;				// Scheduler channel toggling the pin, if any.
+			int8_t generator;			// Timer generating the pulses in hardware, if any.
+			uint32_t wake(uint32_t tic);
 			void write(bool state);
-			void stop();
+			static uint32_t onEdge(EdgeScheduler::Data data, bool state);
 	};
 }
 
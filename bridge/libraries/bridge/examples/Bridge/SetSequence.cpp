@@ -0,0 +1,165 @@
+#include <Arduino.h>
+#include "SetSequence.h"
+
+namespace bridge {
+	uint32_t SetSequence::entries[BRIDGE_SEQUENCE_SIZE];
+	uint8_t SetSequence::length = 0;
+	
+	SetSequence::SetSequence() {
+	}
+	
+	SetSequence::SetSequence(int8_t hid, uint8_t start) :
+	hid(hid),
+	position(start),
+	
+	starting(true),
+	running(true),
+	state(false),
+	pending(false),
+	tic(0),
+	depth(0),
+	channel(-1)
+	{
+		pinMode(hid, OUTPUT);
+		pending = fetch(pendingState, pendingWidth);
+	}
+	
+	// Event receiver. Sets the deadline of the next step and returns whether the routine is still running.
+	bool SetSequence::step(uint32_t tic) {
+		if (starting) {
+			// Initialize.
+			starting = false;
+			bool hold = false;
+			uint32_t width = pending ? advance(hold, merges) : 0;
+			write(state);
+			if (width == 0) {
+				running = false;
+			} else {
+				// Let the timer toggle the pin; otherwise toggle it from here.
+				channel = EdgeScheduler::Start(hid, state, hold ? width | EdgeScheduler::hold : width, onEdge, (EdgeScheduler::Data) this);
+				// With the timer, the end of the sequence is unknown; check for it periodically.
+				this->tic = tic + (channel < 0 ? width : 10000);
+			}
+		} else if (channel >= 0) {
+			// Edges are written by the timer.
+			if (running && Timebase::reached(tic, this->tic))
+				this->tic = tic + 10000;
+		} else if (running && Timebase::reached(tic, this->tic)) {
+			// Next phase change is relative to the ideal time of this one.
+			bool hold;
+			uint32_t width = advance(hold, merges);
+			write(state);
+			if (width == 0)
+				running = false;
+			else
+				this->tic += width;
+		}
+		deadline = until(tic, this->tic);
+		return running;
+	}
+	
+	// Edge written by the scheduler; runs in the interrupt context.
+	uint32_t SetSequence::onEdge(EdgeScheduler::Data data, bool state) {
+		SetSequence* self = (SetSequence*) data;
+		bool hold;
+		uint32_t width = self->advance(hold, edgeMerges);
+		if (width == 0)
+			self->running = false;
+		return hold ? width | EdgeScheduler::hold : width;
+	}
+	
+	// Start the pending segment, merged with up to limit of those following it in the same state; returns its width, or 0 when it is the last phase.
+	// A run cut off by merges or maxWidth stays pending, and hold tells that the phase after this one keeps the state.
+	uint32_t SetSequence::advance(bool &hold, uint8_t limit) {
+		state = pendingState;
+		uint32_t width = pendingWidth;
+		pending = false;
+		bool nextState;
+		uint32_t nextWidth;
+		uint8_t n = 0;
+		while (fetch(nextState, nextWidth)) {
+			if (nextState == state && n < limit && width <= EdgeScheduler::maxWidth - nextWidth) {
+				width += nextWidth;
+				n++;
+			} else {
+				pending = true;
+				pendingState = nextState;
+				pendingWidth = nextWidth;
+				break;
+			}
+		}
+		hold = pending && pendingState == state;
+		return pending ? width : 0;
+	}
+	
+	// Interpret entries up to the next segment.
+	bool SetSequence::fetch(bool &state, uint32_t &width) {
+		for (uint8_t n = 0; n < visits && position < length; n++) {
+			Kind kind = (Kind) (entries[position] >> 24);
+			uint32_t value = entries[position] & 0xFFFFFF;
+			switch (kind) {
+				case Kind::low:
+				case Kind::high:
+					position++;
+					if (value > 0) {
+						state = kind == Kind::high;
+						width = value;
+						return true;
+					}
+					break;
+				case Kind::repeat:
+					if (depth == BRIDGE_SEQUENCE_DEPTH)
+						return false;
+					position++;
+					loops[depth].start = position;
+					loops[depth].remaining = value;
+					depth++;
+					break;
+				case Kind::end:
+					if (depth > 0 && (loops[depth - 1].remaining == 0 || --loops[depth - 1].remaining > 0)) {
+						position = loops[depth - 1].start;
+					} else {
+						if (depth > 0)
+							depth--;
+						position++;
+					}
+					break;
+				default:
+					return false;
+			}
+		}
+		return false;
+	}
+	
+	bool SetSequence::load(uint8_t index, uint8_t kind, uint32_t value) {
+		if (index >= BRIDGE_SEQUENCE_SIZE || index > length || kind > (uint8_t) Kind::stop)
+			return false;
+		// Entries may be read by the scheduler interrupt.
+		noInterrupts();
+		entries[index] = (uint32_t) kind << 24 | (value & 0xFFFFFF);
+		length = index + 1;
+		interrupts();
+		return true;
+	}
+	
+	uint8_t SetSequence::size() {
+		return length;
+	}
+	
+	void SetSequence::stop() {
+		EdgeScheduler::Stop(channel);
+		channel = -1;
+		// Disable routine.
+		running = false;
+	}
+	
+	// Set state and stop any schedule.
+	void SetSequence::write(bool state) {
+		this->state = state;
+		digitalWrite(hid, state);
+	}
+	
+	int SetSequence::index() {
+		return hid;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef SETSEQUENCE_H
+#define SETSEQUENCE_H
+
+#include <stdint.h>
+#include "EdgeScheduler.h"
+#include "Routine.h"
+
+/// Number of segments held by the sequence table.
+#ifndef BRIDGE_SEQUENCE_SIZE
+	#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+		#define BRIDGE_SEQUENCE_SIZE 128
+	#else
+		#define BRIDGE_SEQUENCE_SIZE 24
+	#endif
+#endif
+
+/// Depth of nested repeats.
+#define BRIDGE_SEQUENCE_DEPTH 4
+
+namespace bridge {
+	/*
+		Play the table of segments uploaded with load on a pin.
+		Each entry holds a kind and a 24-bit value: low and high hold the pin for value us; repeat plays the entries up to
+		its matching end value times (0 is forever), and may be nested; stop ends the sequence, as does the end of the table.
+		Consecutive segments of the same state merge into a single phase, written by the scheduler from the ideal time of
+		the previous one. A phase spans at most 32 segments (4 when merged from the scheduler interrupt, to bound the time
+		spent there) and EdgeScheduler::maxWidth; longer runs continue in further phases of the same state, which the
+		scheduler holds rather than toggles. The pin holds the state of the last phase.
+		Sequences also end when 32 entries in a row produce no segment (e.g. an empty loop repeated forever).
+	*/
+	class SetSequence : public Routine {
+		public:
+			static const Type type = Type::setSequence;
+			
+			enum class Kind : uint8_t {low, high, repeat, end, stop};
+			
+			SetSequence();
+			SetSequence(int8_t hid, uint8_t start);
+			bool step(uint32_t tic);
+			int index();
+			void stop();
+			
+			// Write an entry of the table, which then ends after it; false when out of range or not contiguous.
+			static bool load(uint8_t index, uint8_t kind, uint32_t value);
+			static uint8_t size();
+			
+		private:
+			static const uint8_t merges = 32;	// Segments merged into a phase.
+			static const uint8_t edgeMerges = 4;	// Segments merged into a phase from the scheduler interrupt.
+			static const uint8_t visits = 32;	// Entries visited per segment.
+			
+			struct Loop {
+				uint8_t start;			// First entry of the loop.
+				uint32_t remaining;		// Passes left, 0 when forever.
+			};
+			
+			int8_t hid;					// Pin id in hardware.
+			bool starting;				// Whether ticker will start with the next step.
+			volatile bool running;		// Whether the routine is executing.
+			bool state;					// State of the current phase.
+			bool pending;				// Whether a segment follows the current phase.
+			bool pendingState;			// State of that segment.
+			uint32_t pendingWidth;		// Duration of that segment.
+			uint32_t tic;				// Next scheduled phase change.
+			uint8_t position;			// Next entry of the table.
+			uint8_t depth;				// Number of open loops.
+			Loop loops[BRIDGE_SEQUENCE_DEPTH];
+			int8_t channel;				// Scheduler channel toggling the pin, if any.
+			bool fetch(bool &state, uint32_t &width);
+			uint32_t advance(bool &hold, uint8_t limit);
+			void write(bool state);
+			static uint32_t onEdge(EdgeScheduler::Data data, bool state);
+			
+			static uint32_t entries[BRIDGE_SEQUENCE_SIZE];	// Kind in the high byte, value in the lower 24 bits.
+			static uint8_t length;							// Number of entries.
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include <Arduino.h>
+#include "Timebase.h"
+
+namespace bridge {
+	uint32_t Timebase::tic = 0;
+	uint64_t Timebase::ticks = 0;
+	
+	uint32_t Timebase::update() {
+		uint32_t now = micros();
+		ticks += now - tic;
+		tic = now;
+		return now;
+	}
+}
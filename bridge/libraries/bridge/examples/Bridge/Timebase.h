@@ -0,0 +1,45 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+namespace bridge {
+	/*
+		Time (us) of the sketch: a 32-bit tic sampled from micros() once per Step, and its 64-bit extension.
+		The tic wraps every 71.6 minutes, hence tics are compared relative to each other with reached, which holds as long
+		as they are less than 2^31 us (35.8 minutes) apart. The epoch counts microseconds since startup for reports and
+		waits beyond that range; it grows by the difference between consecutive samples, so it stays exact as long as Step
+		runs at least once per wrap, and costs a single addition per Step.
+	*/
+	class Timebase {
+		public:
+			// Sample micros() and extend the epoch; called once per Step.
+			static uint32_t update();
+			
+			// Last sample.
+			static uint32_t now() {
+				return tic;
+			}
+			
+			// Time (us) since startup at the last sample.
+			static uint64_t epoch() {
+				return ticks;
+			}
+			
+			// Time since startup of a tic less than 2^31 us away from the last sample.
+			static uint64_t extend(uint32_t tic) {
+				return ticks + (int32_t) (tic - Timebase::tic);
+			}
+			
+			// Whether a deadline was reached at a tic.
+			static bool reached(uint32_t tic, uint32_t deadline) {
+				return (int32_t) (tic - deadline) >= 0;
+			}
+			
+		private:
+			static uint32_t tic;		// Last sample of micros().
+			static uint64_t ticks;		// Epoch at the last sample.
+	};
+}
+
+#endif
@@ -4,10 +4,19 @@
 #include <stdint.h>
 
 namespace bridge {
+	/// Type of getter producing a report.
+	enum class Kind : uint8_t {
+		binary,		///< Count of changes to low (negative) or high (positive).
+		contact,	///< Contact made (positive) or lost (negative).
+		level,		///< Absolute value of an analog input.
+		rotation,	///< Steps of a rotary encoder.
+		threshold	///< Analog input crossed the threshold upwards (positive) or downwards (negative).
+	};
+	
 	typedef void (*IntFunction   ) (uint8_t id);
 	typedef void (*VoidFunction  ) (void);
-	typedef void (*TicFunction   ) (uint64_t tic);
-	typedef void (*ReportFunction) (int8_t hid, int32_t current, int32_t delta);
+	typedef void (*TicFunction   ) (uint32_t tic);
+	typedef int32_t (*ReportFunction) (int8_t hid, Kind kind, uint32_t tic, int32_t current, int32_t delta);	// Returns the part of delta that was reported.
 }
 
 #endif
\ No newline at end of file
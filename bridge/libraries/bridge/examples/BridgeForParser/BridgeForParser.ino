@@ -12,6 +12,7 @@
 #include "DigitalInput.h"
 #include "TouchSensor.h"
 #include "Oscillator.h"
+#include "Text.h"
 
 using namespace bridge;
 
@@ -125,7 +126,7 @@ void onTouchSensor(TouchSensor* touchSensor, bool state) {
 /// Encode pin in 7 bits and its state in 1 bit.
 void encodeState(uint8_t hid, bool state) {
 	if (debug)
-		Serial.println(String() + hid + ":" + state);
+		Text(&Serial) << hid << ':' << state << F("\r\n");
 	else
 		Serial.write(state ? hid + 127 : hid);
 }
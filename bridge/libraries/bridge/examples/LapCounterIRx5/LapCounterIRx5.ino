@@ -19,6 +19,7 @@
 **/
 
 #include "DigitalInput.h"
+#include "Text.h"
 
 using namespace bridge;
 
@@ -64,7 +65,7 @@ void onSensor(DigitalInput* sensor, bool state, uintptr_t currentVertex) {
 	ledState = bitWrite(ledState, currentVertex, !state);
 	digitalWrite(forwardPin, ledState > 0);
 	// Print sensor state to serial port.
-	Serial.println(String() + seconds + ". Sensor " + currentVertex + (state ? " ON" : " OFF"));
+	Text(&Serial) << seconds << F(". Sensor ") << currentVertex << (state ? F(" ON\r\n") : F(" OFF\r\n"));
 	
 	if (!state) {
 		if (currentVertex == nVertices && previousVertex > 1 && previousVertex < nVertices) {
@@ -80,5 +81,5 @@ void onSensor(DigitalInput* sensor, bool state, uintptr_t currentVertex) {
 
 void setLap(int32_t n) {
 	lap = n;
-	Serial.println(String() + seconds + ". Lap " + lap);
+	Text(&Serial) << seconds << F(". Lap ") << lap << F("\r\n");
 }
\ No newline at end of file
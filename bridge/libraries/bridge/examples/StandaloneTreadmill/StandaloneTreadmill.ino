@@ -15,6 +15,7 @@
 #include "DigitalInput.h"
 #include "Oscillator.h"
 #include "RotaryEncoder.h"
+#include "Text.h"
 #include "TouchSensor.h"
 
 using namespace bridge;
@@ -126,7 +127,7 @@ void onPhotoSensor(DigitalInput* digitalInput, bool state) {
 			}
 		}
 		
-		Serial.println(String() + "tm," + millis() + ",lp," + lapCount + ",lk," + lickCount);
+		Text(&Serial) << F("tm,") << millis() << F(",lp,") << lapCount << F(",lk,") << lickCount << F("\r\n");
 	}
 }
 
@@ -134,7 +135,7 @@ void onPhotoSensor(DigitalInput* digitalInput, bool state) {
 void onFrame(DigitalInput* digitalInput, bool state) {
 	if (state) {
 		frameCount += 1;
-		Serial.println(String() + "tm," + millis() + ",fm," + frameCount + ",rr," + rotaryEncoder.GetValue());
+		Text(&Serial) << F("tm,") << millis() << F(",fm,") << frameCount << F(",rr,") << rotaryEncoder.GetValue() << F("\r\n");
 	}
 }
 
@@ -155,7 +156,7 @@ void onTouchSensor(TouchSensor* touchSensor, bool state) {
 			rewardAvailable = false;
 			if (micros() <= rewardTimeout) {
 				rewardCount += 1;
-				Serial.println(String() + "tm," + millis() + ",rw," + rewardCount);
+				Text(&Serial) << F("tm,") << millis() << F(",rw,") << rewardCount << F("\r\n");
 				reward();
 			}
 		}
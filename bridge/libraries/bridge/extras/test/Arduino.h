@@ -0,0 +1,19 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino stand-in to build sketch sources on the host.
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*) (address))
+#define pgm_read_dword(address) (*(const uint32_t*) (address))
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file ChannelTest.cpp
+ * @brief Compare Channel::next against the floating-point implementation it replaced, and time both.
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "Channel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES "cycles"
+static uint64_t now() {
+	return __rdtsc();
+}
+#else
+#define CYCLES "ns"
+static uint64_t now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+using namespace bridge;
+
+// Channel::next as it was before the 32-bit accumulator, reading from an array instead of serial.
+class Reference {
+	public:
+		Reference(const uint8_t* bytes, uint8_t length) : bytes(bytes), length(length), position(0), nremainder(0) {
+			buffer[0] = 0;
+		}
+		
+		uint64_t next(uint8_t width) {
+			uint8_t nbytes = ceil((width - nremainder) / 8.0);
+			read(buffer + 1, nbytes);
+			uint8_t last = buffer[nbytes];
+			shift(buffer, nbytes + 1, nremainder - 8);
+			uint64_t aligned = pack(buffer, nbytes + 1);
+			nremainder = modcom(width - nremainder, 8);
+			buffer[0] = last & rmask(nremainder);
+			return decompress(aligned, 8 * (nbytes + 1), width);
+		}
+		
+	private:
+		const uint8_t* bytes;
+		uint8_t length;
+		uint8_t position;
+		uint8_t nremainder;
+		uint8_t buffer[8 + 1];
+		
+		void read(uint8_t* destination, uint8_t nbytes) {
+			for (uint8_t i = 0; i < nbytes; i++)
+				destination[i] = position < length ? bytes[position++] : 0;
+		}
+		
+		// Remainder is on the far right of the returned octect.
+		uint8_t shift(uint8_t* bytes, uint8_t nbytes, int8_t s) {
+			uint8_t remainder = 0;
+			if (s > 0) {
+				for (int b = 0; b < nbytes; b++) {
+					uint8_t byte = bytes[b];
+					bytes[b] = (bytes[b] >> s) | remainder;
+					remainder = byte << (8 - s);
+				}
+			} else if (s < 0) {
+				s *= -1;
+				for (int b = nbytes - 1; b >= 0; b--) {
+					uint8_t byte = bytes[b];
+					bytes[b] = bytes[b] << s | remainder;
+					remainder = byte >> (8 - s);
+				}
+			}
+			return remainder;
+		}
+		
+		// Complement of modulus after division, by the same divisor.
+		uint8_t modcom(int8_t x, int8_t k) {
+			return (k - (x % k)) % k;
+		}
+		
+		// Convert an array of bytes to a 64 bit number.
+		uint64_t pack(uint8_t* bytes, uint8_t nbytes) {
+			uint64_t number = 0;
+			for (uint8_t b = 0; b < nbytes; b++)
+				number |= (uint64_t) bytes[b] << 8 * (nbytes - 1 - b);
+			return number;
+		}
+		
+		uint64_t decompress(uint64_t number, uint8_t offset, uint8_t width) {
+			return (number >> (offset - width)) & rmask(width);
+		}
+		
+		uint64_t rmask(uint8_t width) {
+			uint64_t mask = 0;
+			for (uint8_t w = 0; w < width; w++)
+				mask = (mask << 1) | 1;
+			return mask;
+		}
+};
+
+static uint8_t fill(Channel& channel, uint8_t* bytes) {
+	uint8_t length = 1 + rand() % BRIDGE_CHANNEL_SIZE;
+	channel.clear();
+	for (uint8_t i = 0; i < length; i++) {
+		bytes[i] = rand();
+		channel.push(bytes[i]);
+	}
+	return length;
+}
+
+int main() {
+	srand(1);
+	uint8_t bytes[BRIDGE_CHANNEL_SIZE];
+	uint32_t nfields = 0;
+	
+	// Random widths, biased towards the byte-aligned paths and widths Bridge uses.
+	const uint8_t common[] = {1, 4, 7, 8, 12, 16, 24, 32};
+	for (uint32_t trial = 0; trial < 100000; trial++) {
+		Channel channel;
+		uint8_t length = fill(channel, bytes);
+		Reference reference(bytes, length);
+		int16_t nbits = 8 * length;
+		while (true) {
+			uint8_t width = rand() % 3 == 0 ? common[rand() % sizeof(common)] : 1 + rand() % 32;
+			if (width > nbits)
+				break;
+			nbits -= width;
+			uint64_t expected = reference.next(width);
+			uint32_t actual = channel.next(width);
+			if (actual != expected) {
+				printf("ChannelTest: trial %u width %u: expected 0x%llX, got 0x%X\n", trial, width, (unsigned long long) expected, actual);
+				return 1;
+			}
+			nfields++;
+		}
+	}
+	printf("ChannelTest: %u fields match the previous implementation\n", nfields);
+	
+	// set-chirp payload: 8-bit pin followed by five 24-bit fields, 16 bytes in total.
+	const uint32_t n = 1000000;
+	const uint8_t widths[] = {8, 24, 24, 24, 24, 24};
+	const uint8_t nwidths = sizeof(widths);
+	const uint8_t length = 16;
+	for (uint8_t i = 0; i < length; i++)
+		bytes[i] = rand();
+	Channel channel;
+	volatile uint32_t sink = 0;
+	uint64_t t0 = now();
+	for (uint32_t i = 0; i < n; i++) {
+		Reference reference(bytes, length);
+		for (uint8_t w = 0; w < nwidths; w++)
+			sink += reference.next(widths[w]);
+	}
+	// Filling the channel is timed separately and discounted.
+	uint64_t t1 = now();
+	for (uint32_t i = 0; i < n; i++) {
+		channel.clear();
+		for (uint8_t b = 0; b < length; b++)
+			channel.push(bytes[b]);
+		sink += channel.at(i % length);
+	}
+	uint64_t t2 = now();
+	for (uint32_t i = 0; i < n; i++) {
+		channel.clear();
+		for (uint8_t b = 0; b < length; b++)
+			channel.push(bytes[b]);
+		for (uint8_t w = 0; w < nwidths; w++)
+			sink += channel.next(widths[w]);
+	}
+	uint64_t t3 = now();
+	double reference = (double) (t1 - t0) / n / nwidths;
+	double next = ((double) (t3 - t2) - (double) (t2 - t1)) / n / nwidths;
+	printf("ChannelTest: set-chirp fields: previous %.1f, next %.1f " CYCLES " per field\n", reference, next);
+	return 0;
+}
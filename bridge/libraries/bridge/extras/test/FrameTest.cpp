@@ -0,0 +1,124 @@
+/**
+ * @file FrameTest.cpp
+ * @brief Feed corrupted byte streams to Frame and check that valid frames are still recovered.
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Frame.h"
+
+using namespace bridge;
+
+static uint8_t stream[1024];
+static uint16_t nstream;
+
+// Append raw bytes to the stream.
+static void append(const uint8_t* bytes, uint16_t nbytes) {
+	for (uint16_t i = 0; i < nbytes; i++)
+		stream[nstream++] = bytes[i];
+}
+
+// Append an encoded frame whose payload is sequence, sequence + 1, ...
+static void append(uint8_t sequence, uint8_t size) {
+	Frame frame;
+	frame.begin(sequence);
+	for (uint8_t i = 0; i < size; i++)
+		frame.add(sequence + i);
+	append(frame.bytes(), frame.finish());
+}
+
+// Decode the stream as Bridge does and compare the sequence numbers received.
+static bool check(const char* name, const uint8_t* expected, uint8_t nexpected) {
+	Frame frame;
+	uint8_t nreceived = 0;
+	bool pass = true;
+	for (uint16_t i = 0; i < nstream; i++) {
+		bool ready = frame.push(stream[i]);
+		while (ready) {
+			uint8_t sequence = frame.sequence();
+			for (uint8_t j = 0; j < frame.size(); j++)
+				pass &= frame.at(j) == (uint8_t) (sequence + j);
+			pass &= nreceived < nexpected && sequence == expected[nreceived];
+			nreceived++;
+			ready = frame.next();
+		}
+	}
+	pass &= nreceived == nexpected;
+	printf("FrameTest: %s: %u of %u frames, %u errors: %s\n", name, nreceived, nexpected, frame.errors, pass ? "pass" : "FAIL");
+	nstream = 0;
+	return pass;
+}
+
+int main() {
+	bool pass = true;
+	
+	// Bad CRC, then resync onto bytes that already exceed the next candidate's length, then garbage.
+	const uint8_t corrupted[] = {0xA5, 0x0A, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0xA5, 0x00, 0x00, 0x09, 0x09, 0xEE};
+	append(corrupted, sizeof(corrupted));
+	for (uint8_t i = 0; i < 46; i++)
+		stream[nstream++] = 0x10 + i;
+	append(1, 5);
+	append(2, BRIDGE_FRAME_SIZE);
+	const uint8_t expected1[] = {1, 2};
+	pass &= check("corrupted stream", expected1, sizeof(expected1));
+	
+	// A truncated frame swallows the next ones; they are recovered from the bytes kept after the resync.
+	const uint8_t truncated[] = {0xA5, 0x08, 0x07};
+	append(truncated, sizeof(truncated));
+	append(3, 2);
+	append(4, 0);
+	append(5, 1);
+	const uint8_t expected2[] = {3, 4, 5};
+	pass &= check("truncated frame", expected2, sizeof(expected2));
+	
+	// Candidates of the largest size overlapping each other and the frames that follow.
+	for (uint8_t i = 0; i < 200; i++)
+		stream[nstream++] = i % 2 == 0 ? Frame::sync : BRIDGE_FRAME_SIZE;
+	append(6, 3);
+	append(7, 20);
+	append(8, 20);
+	append(9, 20);
+	const uint8_t expected3[] = {6, 7, 8, 9};
+	pass &= check("repeated sync", expected3, sizeof(expected3));
+	
+	// Random drops and substitutions. CRC-8 lets about 1 in 256 bad candidates through, so count intact frames.
+	srand(1);
+	Frame frame;
+	uint32_t nframes = 0;
+	uint32_t nintact = 0;
+	for (uint32_t i = 0; i < 20000; i++) {
+		uint8_t sequence = i;
+		Frame source;
+		source.begin(sequence);
+		uint8_t size = rand() % (BRIDGE_FRAME_SIZE + 1);
+		for (uint8_t j = 0; j < size; j++)
+			source.add(sequence + j);
+		uint8_t nbytes = source.finish();
+		const uint8_t* bytes = source.bytes();
+		for (uint8_t j = 0; j < nbytes; j++) {
+			uint8_t byte = bytes[j];
+			int r = rand() % 500;
+			if (r == 0)
+				continue;
+			else if (r == 1)
+				byte = rand();
+			bool ready = frame.push(byte);
+			while (ready) {
+				bool intact = true;
+				for (uint8_t k = 0; k < frame.size(); k++)
+					intact &= frame.at(k) == (uint8_t) (frame.sequence() + k);
+				nintact += intact;
+				nframes++;
+				ready = frame.next();
+			}
+		}
+	}
+	bool recovered = nintact >= 17000 && nframes - nintact <= 20;
+	printf("FrameTest: random corruption: %u of 20000 frames intact, %u not, %u errors: %s\n", nintact, nframes - nintact, frame.errors, recovered ? "pass" : "FAIL");
+	pass &= recovered;
+	
+	return pass ? 0 : 1;
+}
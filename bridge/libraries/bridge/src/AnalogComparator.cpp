@@ -0,0 +1,69 @@
+/**
+ * @file AnalogComparator.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Detect crossings of an analog input over a reference with the analog comparator interrupt.
+ */
+
+#include <Arduino.h>
+#include "AnalogComparator.h"
+#include "AnalogSampler.h"
+
+namespace bridge {
+	int8_t AnalogComparator::pin = -1;
+	bool AnalogComparator::multiplexed = false;
+	AnalogComparator::Function AnalogComparator::function = nullptr;
+	AnalogComparator::Data AnalogComparator::data = 0;
+
+	bool AnalogComparator::Attach(int8_t pin, Reference reference, Function function, Data data) {
+		if (AnalogComparator::pin >= 0 || !Vectors())
+			return false;
+		if (pin == BRIDGE_COMPARATOR_AIN1)
+			multiplexed = false;
+		else if (AnalogSampler::Lend(pin))
+			multiplexed = true;
+		else
+			return false;
+		AnalogComparator::pin = pin;
+		AnalogComparator::function = function;
+		AnalogComparator::data = data;
+		// Interrupt disabled while the inputs change, on every toggle of the output.
+		ACSR = reference == Reference::Bandgap ? _BV(ACBG) : 0;
+		// Let the bandgap reference settle.
+		delayMicroseconds(100);
+		ACSR |= _BV(ACI);
+		ACSR |= _BV(ACIE);
+		return true;
+	}
+
+	void AnalogComparator::Detach(int8_t pin) {
+		if (pin < 0 || pin != AnalogComparator::pin)
+			return;
+		ACSR &= ~_BV(ACIE);
+		ACSR |= _BV(ACI);
+		if (multiplexed)
+			AnalogSampler::Reclaim();
+		AnalogComparator::pin = -1;
+	}
+
+	bool AnalogComparator::Read() {
+		// The output is high while the positive input (reference) is above the negative input (pin).
+		return !(ACSR & _BV(ACO));
+	}
+
+	int8_t AnalogComparator::Multiplexed() {
+		return multiplexed ? pin : -1;
+	}
+
+	void AnalogComparator::Dispatch() {
+		if (function)
+			function(data, Read());
+	}
+
+	// Replaced by the definition in BRIDGE_COMPARATOR_VECTORS.
+	__attribute__((weak)) bool AnalogComparator::Vectors() {
+		return false;
+	}
+}
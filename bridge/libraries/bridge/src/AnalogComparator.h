@@ -0,0 +1,93 @@
+/**
+ * @file AnalogComparator.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Detect crossings of an analog input over a reference with the analog comparator interrupt.
+ */
+
+#ifndef BRIDGE_ANALOGCOMPARATOR_H
+#define BRIDGE_ANALOGCOMPARATOR_H
+
+#include <Arduino.h>
+
+/// Digital pin wired to AIN1, the negative input of the analog comparator; -1 when not available.
+#ifndef BRIDGE_COMPARATOR_AIN1
+	#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+		#define BRIDGE_COMPARATOR_AIN1 5
+	#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+		#define BRIDGE_COMPARATOR_AIN1 7
+	#else
+		#define BRIDGE_COMPARATOR_AIN1 -1
+	#endif
+#endif
+
+namespace bridge {
+	/**
+	 * @class AnalogComparator
+	 * @brief Crossings of one input over a reference, reported from the interrupt context.
+	 * @details The comparator compares its positive input, the internal bandgap (1.1V) or the voltage on AIN0, with
+	 * its negative input: the AIN1 pin, or an analog pin through the ADC multiplexer while the ADC is off (see
+	 * AnalogSampler::Lend). Its interrupt fires on every change of the output, within a clock cycle of the crossing,
+	 * and its service routine invokes the registered function with the new state, so that idle inputs cost no CPU
+	 * time. The comparator has no hysteresis, hence a noisy input near the reference may interrupt repeatedly.
+	 * The service routine of the analog comparator interrupt is only defined by sketches expanding
+	 * BRIDGE_COMPARATOR_VECTORS; until then, Attach fails.
+	 */
+	class AnalogComparator {
+		public:
+			/// @typedef User data to include during a callback.
+			typedef uintptr_t Data;
+
+			/// @typedef Function to invoke from the interrupt context with whether the input is above the reference.
+			typedef void (*Function) (Data data, bool state);
+
+			/// Positive input of the comparator.
+			enum class Reference : uint8_t {
+				Bandgap,	///< Internal bandgap reference (1.1V).
+				AIN0		///< Voltage on the AIN0 pin.
+			};
+
+			/**
+			 * @brief Invoke function(data, state) when a pin crosses the reference.
+			 * @param[in] pin AIN1, or an analog pin when the ADC multiplexer can be lent.
+			 * @param[in] reference Positive input of the comparator.
+			 * @param[in] function Function to invoke on change.
+			 * @param[in] data User data to include in the callback.
+			 * @return Whether the comparator was free, the pin reaches its negative input, and the service routine is defined.
+			 */
+			static bool Attach(int8_t pin, Reference reference, Function function, Data data);
+
+			/**
+			 * @brief Stop listening to a pin, if attached.
+			 * @param[in] pin GPIO number.
+			 */
+			static void Detach(int8_t pin);
+
+			/// @return Whether the attached pin is above the reference.
+			static bool Read();
+
+			/// @return Attached pin when selected through the ADC multiplexer, else -1.
+			static int8_t Multiplexed();
+
+			/// @brief Invoke the registered function; invoked by the interrupt service routine.
+			static void Dispatch();
+
+			/// @return Whether the sketch defined the service routine (see BRIDGE_COMPARATOR_VECTORS).
+			static bool Vectors();
+
+		private:
+			static int8_t pin;				///< Attached pin, -1 when free.
+			static bool multiplexed;		///< Whether the pin is selected through the ADC multiplexer.
+			static Function function;		///< Function to invoke on change.
+			static Data data;				///< User data to include in the callback.
+	};
+}
+
+/// Define the service routine of AnalogComparator; expand once, at global scope, in a sketch that lets it use it.
+#define BRIDGE_COMPARATOR_VECTORS \
+	bool bridge::AnalogComparator::Vectors() {return true;} \
+	ISR(ANALOG_COMP_vect) {bridge::AnalogComparator::Dispatch();}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file AnalogFilter.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Smooth 10-bit analog samples in fixed point.
+ */
+
+#include <Arduino.h>
+#include "AnalogFilter.h"
+
+namespace bridge {
+	static_assert(BRIDGE_FILTER_SIZE >= 8 && BRIDGE_FILTER_SIZE <= 64 && (BRIDGE_FILTER_SIZE & (BRIDGE_FILTER_SIZE - 1)) == 0, "BRIDGE_FILTER_SIZE must be a power of two from 8 to 64.");
+
+	AnalogFilter::AnalogFilter() :
+	type(Type::None),
+	parameter(0),
+	primed(false),
+	head(0),
+	state(0)
+	{
+	}
+
+	void AnalogFilter::Setup(Type type, uint8_t parameter) {
+		uint8_t maxShift = 0;
+		while ((1 << (maxShift + 1)) <= size)
+			maxShift++;
+		switch (type) {
+			case Type::Exponential:
+				parameter = constrain(parameter, 1, 8);
+				break;
+			case Type::Average:
+				parameter = constrain(parameter, 1, maxShift);
+				break;
+			case Type::Median:
+				parameter = parameter > 3 ? 5 : 3;
+				break;
+			default:
+				type = Type::None;
+				parameter = 0;
+		}
+		this->type = type;
+		this->parameter = parameter;
+		primed = false;
+	}
+
+	uint16_t AnalogFilter::Filter(uint16_t sample) {
+		if (!primed) {
+			primed = true;
+			head = 0;
+			for (uint8_t i = 0; i < size; i++)
+				history[i] = sample;
+			state = type == Type::Exponential ? (uint32_t) sample << 16 : (uint32_t) sample << parameter;
+		}
+		switch (type) {
+			case Type::Exponential: {
+				// State moves by a 2^-k fraction of its difference with the sample.
+				int32_t difference = ((int32_t) sample << 16) - (int32_t) state;
+				state += difference >> parameter;
+				return (state + 0x8000) >> 16;
+			}
+			case Type::Average: {
+				// Replace the oldest sample of the window in the running sum.
+				uint8_t window = 1 << parameter;
+				uint8_t oldest = (head - window) & (size - 1);
+				state += sample - history[oldest];
+				history[head] = sample;
+				head = (head + 1) & (size - 1);
+				return (state + (window >> 1)) >> parameter;
+			}
+			case Type::Median: {
+				history[head] = sample;
+				head = (head + 1) & (size - 1);
+				// Insertion sort of the last taps.
+				uint16_t taps[5];
+				for (uint8_t i = 0; i < parameter; i++) {
+					uint16_t value = history[(head - 1 - i) & (size - 1)];
+					uint8_t j = i;
+					for (; j > 0 && taps[j - 1] > value; j--)
+						taps[j] = taps[j - 1];
+					taps[j] = value;
+				}
+				return taps[parameter >> 1];
+			}
+			default:
+				return sample;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+/**
+ * @file AnalogFilter.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Smooth 10-bit analog samples in fixed point.
+ */
+
+#ifndef BRIDGE_ANALOGFILTER_H
+#define BRIDGE_ANALOGFILTER_H
+
+#include <stdint.h>
+
+/// Number of samples held for moving averages (a power of two, up to 64).
+#ifndef BRIDGE_FILTER_SIZE
+#define BRIDGE_FILTER_SIZE 16
+#endif
+
+namespace bridge {
+	/**
+	 * @class AnalogFilter
+	 * @brief Exponential, moving average or median filter of analog samples.
+	 * @details Filters only use integer additions and shifts: the exponential filter keeps its state in Q10.16 and
+	 * moves it by a 2^-k fraction of the difference with each sample, the moving average keeps a running sum of a
+	 * window of 2^k samples, and the median sorts the last 3 or 5 samples. The history is filled with the first
+	 * sample, so that the output starts at the input rather than rising from 0.
+	 */
+	class AnalogFilter {
+		public:
+			/// Filter applied to samples.
+			enum class Type : uint8_t {
+				None,			///< Samples are passed through.
+				Exponential,	///< First-order low pass with a time constant of 2^k samples.
+				Average,		///< Mean of the last 2^k samples.
+				Median			///< Median of the last 3 or 5 samples.
+			};
+
+			AnalogFilter();
+
+			/**
+			 * @brief Select a filter and clear its history.
+			 * @param[in] type Filter.
+			 * @param[in] parameter Exponential: k, from 1 to 8. Average: k, from 1 to log2(BRIDGE_FILTER_SIZE). Median: number
+			 * of taps, 3 or 5. Values out of range are clamped.
+			 */
+			void Setup(Type type, uint8_t parameter);
+
+			/**
+			 * @brief Filter a new sample.
+			 * @param[in] sample Sample, from 0 to 1023.
+			 * @return Filtered value, from 0 to 1023.
+			 */
+			uint16_t Filter(uint16_t sample);
+
+		private:
+			static const uint8_t size = BRIDGE_FILTER_SIZE;
+
+			Type type;						///< Filter applied to samples.
+			uint8_t parameter;				///< Shift (k) or number of taps.
+			bool primed;					///< Whether the history holds samples.
+			uint8_t head;					///< Position of the next sample in the history.
+			uint32_t state;					///< Exponential: filtered value in Q10.16. Average: sum of the window.
+			uint16_t history[size];			///< Last samples, oldest first from head.
+	};
+}
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file AnalogSampler.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Sample analog inputs in the background, in turns, from the ADC conversion complete interrupt.
+ */
+
+#include <Arduino.h>
+#include "AnalogSampler.h"
+
+// Auto trigger source of the ADC: Timer1 compare match B.
+#define BRIDGE_ADC_TRIGGER (_BV(ADTS2) | _BV(ADTS0))
+
+// Prescaler of the ADC clock: 128 (125 kHz) as in the Arduino core, or 64 (250 kHz) for short periods.
+#define BRIDGE_ADC_CLOCK128 (_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0))
+#define BRIDGE_ADC_CLOCK64 (_BV(ADPS2) | _BV(ADPS1))
+
+namespace bridge {
+	static_assert(AnalogSampler::nChannels <= 16, "AnalogSampler tracks up to 16 channels.");
+	static_assert(AnalogSampler::blockSize % 4 == 0, "BRIDGE_STREAM_SIZE must be a multiple of 4.");
+
+	volatile uint16_t AnalogSampler::samples[AnalogSampler::nChannels];
+	volatile uint8_t AnalogSampler::counts[AnalogSampler::nChannels];
+	volatile uint16_t AnalogSampler::active = 0;
+	volatile uint16_t AnalogSampler::fresh = 0;
+	volatile uint8_t AnalogSampler::current = 0;
+	volatile bool AnalogSampler::running = false;
+	uint8_t AnalogSampler::users[AnalogSampler::nChannels];
+	volatile bool AnalogSampler::streaming = false;
+	bool AnalogSampler::lent = false;
+	AnalogSampler::Block AnalogSampler::blocks[2];
+	volatile bool AnalogSampler::full[2] = {false, false};
+	volatile uint8_t AnalogSampler::filling = 0;
+	volatile uint8_t AnalogSampler::position = 0;
+
+	bool AnalogSampler::Attach(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		if (channel < 0 || !Vectors())
+			return false;
+		uint16_t mask = (uint16_t) 1 << channel;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		if (users[channel]++ == 0) {
+			active |= mask;
+			fresh &= ~mask;
+		}
+		if (!running && !streaming && !lent) {
+			running = true;
+			current = channel;
+			Start(channel);
+		}
+		SREG = sreg;
+		return true;
+	}
+
+	void AnalogSampler::Detach(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		if (channel < 0 || users[channel] == 0)
+			return;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		// The sampler stops by itself after the conversion in progress once no channel is left.
+		if (--users[channel] == 0)
+			active &= ~((uint16_t) 1 << channel);
+		SREG = sreg;
+	}
+
+	uint16_t AnalogSampler::Read(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		if (channel < 0)
+			return 0;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		uint16_t sample = samples[channel];
+		SREG = sreg;
+		return sample;
+	}
+
+	uint8_t AnalogSampler::Count(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		return channel < 0 ? 0 : counts[channel];
+	}
+
+	uint16_t AnalogSampler::Wait(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		if (channel < 0 || users[channel] == 0)
+			return 0;
+		// Bits are only set by the service routine, so a torn read merely delays the exit.
+		uint16_t mask = (uint16_t) 1 << channel;
+		while (!(fresh & mask) && !streaming && !lent) {}
+		return Read(pin);
+	}
+
+	bool AnalogSampler::Stream(uint8_t pin, uint16_t period) {
+		int8_t channel = Channel(pin);
+		if (channel < 0 || period < minPeriod || period > maxPeriod || streaming || lent || !Vectors() || !PulseGenerator::Reserve(1))
+			return false;
+		// Let the conversion in progress end without starting another one.
+		uint8_t sreg = SREG;
+		noInterrupts();
+		streaming = true;
+		running = false;
+		ADCSRA &= ~_BV(ADIE);
+		SREG = sreg;
+		while (ADCSRA & _BV(ADSC)) {}
+
+		full[0] = false;
+		full[1] = false;
+		filling = 0;
+		position = 0;
+		blocks[0].sequence = 0;
+		uint16_t ticks = period * (F_CPU / 8000000UL);
+		sreg = SREG;
+		noInterrupts();
+		// CTC mode with TOP at OCR1A and a prescaler of 8; compare match B happens once per period.
+		TCCR1B = 0;
+		TCCR1A = 0;
+		TIMSK1 = 0;
+		TCNT1 = 0;
+		OCR1A = ticks - 1;
+		OCR1B = ticks - 1;
+		TIFR1 = _BV(OCF1B);
+		Select(channel);
+		ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | BRIDGE_ADC_TRIGGER;
+		ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF) | (period < 120 ? BRIDGE_ADC_CLOCK64 : BRIDGE_ADC_CLOCK128);
+		TCCR1B = _BV(WGM12) | _BV(CS11);
+		SREG = sreg;
+		return true;
+	}
+
+	void AnalogSampler::Unstream() {
+		if (!streaming)
+			return;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		TCCR1B = 0;
+		ADCSRA = _BV(ADEN) | _BV(ADIF) | BRIDGE_ADC_CLOCK128;
+		ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));
+		SREG = sreg;
+		PulseGenerator::Free(1);
+		while (ADCSRA & _BV(ADSC)) {}
+
+		streaming = false;
+		Resume();
+	}
+
+	// While a block is handed over, the stream fills the other one, hence the block handed over does not change.
+	AnalogSampler::Block* AnalogSampler::Take() {
+		uint8_t other = filling ^ 1;
+		return full[other] ? &blocks[other] : nullptr;
+	}
+
+	void AnalogSampler::Release() {
+		full[filling ^ 1] = false;
+	}
+
+	bool AnalogSampler::Lend(uint8_t pin) {
+		int8_t channel = Channel(pin);
+		if (channel < 0 || active || streaming || lent)
+			return false;
+		// The sampler stops by itself once the conversion in progress ends.
+		while (running) {}
+		uint8_t sreg = SREG;
+		noInterrupts();
+		lent = true;
+		ADCSRA &= ~(_BV(ADEN) | _BV(ADIE));
+		Select(channel);
+		ADCSRB |= _BV(ACME);
+		SREG = sreg;
+		return true;
+	}
+
+	void AnalogSampler::Reclaim() {
+		if (!lent)
+			return;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		ADCSRB &= ~_BV(ACME);
+		ADCSRA |= _BV(ADEN);
+		lent = false;
+		SREG = sreg;
+		Resume();
+	}
+
+	void AnalogSampler::Complete() {
+		if (streaming) {
+			Collect(ADC);
+			return;
+		}
+		uint8_t channel = current;
+		samples[channel] = ADC;
+		counts[channel]++;
+		fresh |= (uint16_t) 1 << channel;
+		uint16_t mask = active;
+		if (mask == 0) {
+			ADCSRA &= ~_BV(ADIE);
+			running = false;
+			return;
+		}
+		// Next attached channel, round-robin.
+		do {
+			channel = channel + 1 == nChannels ? 0 : channel + 1;
+		} while (!(mask & ((uint16_t) 1 << channel)));
+		current = channel;
+		Start(channel);
+	}
+
+	// Channel of a pin, as in analogRead.
+	int8_t AnalogSampler::Channel(uint8_t pin) {
+		if (pin >= A0)
+			pin -= A0;
+		return pin < nChannels ? pin : -1;
+	}
+
+	// Select the channel of the next conversion, with the default reference.
+	void AnalogSampler::Select(uint8_t channel) {
+		#if defined(MUX5)
+			ADCSRB = (ADCSRB & ~_BV(MUX5)) | ((channel >> 3) & 1) << MUX5;
+		#endif
+		ADMUX = _BV(REFS0) | (channel & 0x07);
+	}
+
+	// Select a channel and start its conversion, with the conversion complete interrupt enabled.
+	void AnalogSampler::Start(uint8_t channel) {
+		Select(channel);
+		ADCSRA |= _BV(ADIE) | _BV(ADSC);
+	}
+
+	// Restart sampling from the first attached channel, if any.
+	void AnalogSampler::Resume() {
+		uint8_t sreg = SREG;
+		noInterrupts();
+		uint16_t mask = active;
+		if (mask && !running) {
+			uint8_t channel;
+			for (channel = 0; !(mask & ((uint16_t) 1 << channel)); channel++) {}
+			running = true;
+			current = channel;
+			Start(channel);
+		}
+		SREG = sreg;
+	}
+
+	// Store a sample of the stream; full blocks are handed over, or dropped while the other block is still out.
+	void AnalogSampler::Collect(uint16_t sample) {
+		// The next trigger is the next rising edge of the compare flag, which is not cleared by an interrupt.
+		TIFR1 = _BV(OCF1B);
+		Block& block = blocks[filling];
+		if (position == 0)
+			block.tic = micros();
+		block.samples[position++] = sample;
+		if (position == blockSize) {
+			position = 0;
+			uint8_t sequence = block.sequence + 1;
+			uint8_t other = filling ^ 1;
+			if (!full[other]) {
+				full[filling] = true;
+				filling = other;
+			}
+			blocks[filling].sequence = sequence;
+		}
+	}
+
+	// Replaced by the definition in BRIDGE_SAMPLER_VECTORS.
+	__attribute__((weak)) bool AnalogSampler::Vectors() {
+		return false;
+	}
+}
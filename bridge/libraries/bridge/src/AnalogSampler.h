@@ -0,0 +1,146 @@
+/**
+ * @file AnalogSampler.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Sample analog inputs in the background, in turns, from the ADC conversion complete interrupt.
+ */
+
+#ifndef BRIDGE_ANALOGSAMPLER_H
+#define BRIDGE_ANALOGSAMPLER_H
+
+#include <Arduino.h>
+#include "PulseGenerator.h"
+
+/// Number of samples per block of a stream (a multiple of 4).
+#ifndef BRIDGE_STREAM_SIZE
+#define BRIDGE_STREAM_SIZE 32
+#endif
+
+namespace bridge {
+	/**
+	 * @class AnalogSampler
+	 * @brief Latest sample of each attached analog input, refreshed by the ADC without waiting on it.
+	 * @details Each conversion ends in the ADC conversion complete interrupt, whose service routine stores the result
+	 * of the channel and starts a conversion of the next attached channel, round-robin; the sampler stops once no
+	 * channel is attached. Reading a sample is therefore a copy, rather than the 112us spent by analogRead waiting
+	 * for a conversion. With the prescaler of the Arduino core (125 kHz ADC clock), each of n attached channels is
+	 * sampled every n * 104us.
+	 * Conversions use the default reference (AVcc) and the multiplexer is switched right before each one, so sources
+	 * should have an output impedance below 10 kOhm. analogRead must not be used while channels are attached.
+	 * Alternatively, one channel is streamed: Timer1 runs in CTC mode with a period of 0.5us ticks, and its compare
+	 * match B auto-triggers conversions, so that samples are evenly spaced regardless of interrupt latency. Samples
+	 * fill two blocks in turns; a block is handed over once full, while the other one fills. When the block handed
+	 * over was not released by then, the new block is dropped, and its sequence number skipped. Attached channels hold
+	 * their last sample while streaming. Streams need Timer1 (see PulseGenerator::Reserve), hence are not available
+	 * where it belongs to EdgeScheduler (e.g. the Uno).
+	 * The multiplexer may also be lent to the analog comparator, with the ADC off; channels attached meanwhile read 0
+	 * until it is reclaimed.
+	 * The service routine of the ADC conversion complete interrupt is only defined by sketches expanding
+	 * BRIDGE_SAMPLER_VECTORS; until then, channels are neither attached nor streamed.
+	 */
+	class AnalogSampler {
+		public:
+			/// Number of analog channels.
+			static const uint8_t nChannels = NUM_ANALOG_INPUTS;
+
+			/// Number of samples per block of a stream.
+			static const uint8_t blockSize = BRIDGE_STREAM_SIZE;
+
+			/// Shortest period (us) of a stream; conversions take 52us with an ADC clock of 250 kHz.
+			static const uint16_t minPeriod = 100;
+
+			/// Longest period (us) of a stream, within the 16-bit range of Timer1.
+			static const uint16_t maxPeriod = 0xFFFF / (F_CPU / 8000000UL);
+
+			/// Consecutive samples of a stream.
+			struct Block {
+				uint8_t sequence;				///< Number of the block, counting dropped blocks.
+				uint32_t tic;					///< Time (us) at which the first sample was stored.
+				uint16_t samples[blockSize];	///< Samples (0 to 1023), one per period.
+			};
+
+			/**
+			 * @brief Sample an analog input in turns with the others, starting the sampler if idle.
+			 * @param[in] pin Analog pin (e.g. A0) or channel number, as accepted by analogRead.
+			 * @return Whether the pin is an analog input and the service routine is defined; attachments are counted per channel.
+			 */
+			static bool Attach(uint8_t pin);
+
+			/// @brief Undo an attachment; the channel is no longer sampled once all are undone.
+			static void Detach(uint8_t pin);
+
+			/// @return Latest sample (0 to 1023) of an attached pin.
+			static uint16_t Read(uint8_t pin);
+
+			/// @return Number of samples taken from a pin, modulo 256; a change tells a new sample from the one read last.
+			static uint8_t Count(uint8_t pin);
+
+			/// @return First sample of an attached pin taken after it was attached, waiting for it if needed; 0 if not attached.
+			static uint16_t Wait(uint8_t pin);
+
+			/**
+			 * @brief Stream an analog input at a fixed rate, pausing the sampling of attached channels.
+			 * @param[in] pin Analog pin (e.g. A0) or channel number, as accepted by analogRead.
+			 * @param[in] period Time (us) between samples, from minPeriod to maxPeriod.
+			 * @return Whether the stream started; false when the period is out of range, when Timer1 or the stream is in use,
+			 * or when the service routine is not defined.
+			 */
+			static bool Stream(uint8_t pin, uint16_t period);
+
+			/// @brief Stop the stream, if any, dropping pending samples, and resume the sampling of attached channels.
+			static void Unstream();
+
+			/// @return Full block of the stream not yet released, if any.
+			static Block* Take();
+
+			/// @brief Hand the block returned by Take back to the stream.
+			static void Release();
+
+			/**
+			 * @brief Turn the ADC off and select a channel as the negative input of the analog comparator.
+			 * @param[in] pin Analog pin (e.g. A0) or channel number, as accepted by analogRead.
+			 * @return Whether the multiplexer was lent; false when channels are attached, streamed, or the multiplexer is lent.
+			 */
+			static bool Lend(uint8_t pin);
+
+			/// @brief Turn the ADC back on, and resume the sampling of channels attached meanwhile.
+			static void Reclaim();
+
+			/// @brief Store a conversion and start the next one; invoked by the ADC service routine.
+			static void Complete();
+
+			/// @return Whether the sketch defined the service routine (see BRIDGE_SAMPLER_VECTORS).
+			static bool Vectors();
+
+		private:
+			static int8_t Channel(uint8_t pin);
+			static void Select(uint8_t channel);
+			static void Start(uint8_t channel);
+			static void Resume();
+			static void Collect(uint16_t sample);
+
+			static volatile uint16_t samples[nChannels];	///< Latest sample of each channel.
+			static volatile uint8_t counts[nChannels];		///< Number of samples of each channel, modulo 256.
+			static volatile uint16_t active;				///< Channels sampled, one bit each.
+			static volatile uint16_t fresh;					///< Channels sampled since attached, one bit each.
+			static volatile uint8_t current;				///< Channel being converted.
+			static volatile bool running;					///< Whether a conversion is in progress.
+			static uint8_t users[nChannels];				///< Attachments of each channel.
+
+			static volatile bool streaming;					///< Whether conversions are triggered by Timer1.
+			static bool lent;								///< Whether the multiplexer is lent to the analog comparator.
+			static Block blocks[2];							///< Block being filled and block handed over.
+			static volatile bool full[2];					///< Whether each block is full and not released.
+			static volatile uint8_t filling;				///< Block being filled.
+			static volatile uint8_t position;				///< Next sample of the block being filled.
+	};
+}
+
+/// Define the service routine of AnalogSampler; expand once, at global scope, in a sketch that lets it use it.
+#define BRIDGE_SAMPLER_VECTORS \
+	bool bridge::AnalogSampler::Vectors() {return true;} \
+	ISR(ADC_vect) {bridge::AnalogSampler::Complete();}
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file Chirp.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Phase widths of a frequency sweep, in 32-bit fixed point.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "Chirp.h"
+
+namespace bridge {
+	// Fraction of 2^(i/16) - 1, in Q0.16.
+	static const uint16_t exp2Table[16] PROGMEM = {0, 2902, 5932, 9096, 12400, 15850, 19454, 23216, 27146, 31249, 35534, 40009, 44682, 49562, 54658, 59979};
+
+	Chirp::Chirp() :
+	shape(Shape::Linear),
+	duration(1),
+	rate(0xFFFFFFFFUL),
+	scale(0),
+	elapsed(1)
+	{
+	}
+
+	void Chirp::Setup(uint32_t lowStart, uint32_t lowStop, uint32_t highStart, uint32_t highStop, uint32_t duration, Shape shape) {
+		if (shape == Shape::Exponential && (lowStart == 0 || lowStop == 0 || highStart == 0 || highStop == 0))
+			shape = Shape::Linear;
+		this->shape = shape;
+		low.start = lowStart;
+		high.start = highStart;
+		if (shape == Shape::Exponential) {
+			// Base-2 logarithm of the ratio between stop and start widths, computed once.
+			low.change = lround(log((float) lowStop / lowStart) * (65536 / M_LN2));
+			high.change = lround(log((float) highStop / highStart) * (65536 / M_LN2));
+		} else {
+			low.change = (int32_t) (lowStop - lowStart);
+			high.change = (int32_t) (highStop - highStart);
+		}
+		this->duration = max(duration, 1UL);
+		// Scale times down to 16 bits, so that the reciprocal keeps 16 significant bits.
+		for (scale = 0; (this->duration >> scale) > 0xFFFF; scale++) {}
+		rate = 0xFFFFFFFFUL / (this->duration >> scale);
+		elapsed = 0;
+	}
+
+	uint32_t Chirp::Next(bool state) {
+		if (elapsed >= duration)
+			return 0;
+		// Elapsed time is less than the duration, hence its product with the reciprocal fits 32 bits.
+		uint16_t progress = ((elapsed >> scale) * rate) >> 16;
+		uint32_t width = Width(state ? high : low, progress);
+		elapsed += width;
+		return width;
+	}
+
+	uint32_t Chirp::Width(const Sweep& sweep, uint16_t progress) {
+		int32_t width;
+		if (shape == Shape::Exponential)
+			width = Exp2(Multiply(sweep.change, progress), sweep.start);
+		else
+			width = sweep.start + Multiply(sweep.change, progress);
+		return width > 0 ? width : 1;
+	}
+
+	// Product of a signed value and a Q0.16 fraction, split in 16x16-bit products.
+	int32_t Chirp::Multiply(int32_t value, uint16_t fraction) {
+		return (value >> 16) * (int32_t) fraction + (int32_t) (((uint32_t) (value & 0xFFFF) * fraction) >> 16);
+	}
+
+	// Product of a value and 2 to a Q16.16 exponent; the fraction of the exponent is interpolated from a 16-entry table.
+	uint32_t Chirp::Exp2(int32_t exponent, uint32_t value) {
+		int8_t shift = exponent >> 16;
+		uint16_t fraction = exponent & 0xFFFF;
+		uint8_t i = fraction >> 12;
+		uint32_t a = pgm_read_word(&exp2Table[i]);
+		uint32_t b = i == 15 ? 0x10000UL : pgm_read_word(&exp2Table[i + 1]);
+		uint16_t mantissa = a + (((b - a) * (fraction & 0x0FFF)) >> 12);
+		// Shift left before, and right after the multiplication, to keep the fraction.
+		if (shift >= 0) {
+			value <<= shift;
+			return value + Multiply(value, mantissa);
+		} else {
+			value += Multiply(value, mantissa);
+			return value >> -shift;
+		}
+	}
+}
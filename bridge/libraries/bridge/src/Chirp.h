@@ -0,0 +1,75 @@
+/**
+ * @file Chirp.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Phase widths of a frequency sweep, in 32-bit fixed point.
+ */
+
+#ifndef BRIDGE_CHIRP_H
+#define BRIDGE_CHIRP_H
+
+#include <stdint.h>
+
+namespace bridge {
+	/**
+	 * @class Chirp
+	 * @brief Widths of the low and high phases of a square wave sweeping between two frequencies.
+	 * @details A phase accumulator holds the time elapsed since the start of the sweep; each edge adds the width of
+	 * the phase it starts, and its product with the reciprocal of the duration, computed once, gives the progress of
+	 * the sweep as a 32-bit fraction. Times are scaled down to 16 bits first, so that the reciprocal keeps 16
+	 * significant bits. Widths are interpolated from that fraction either linearly, or exponentially (constant ratio
+	 * per unit of time, i.e. a logarithmic sweep) through a 2^x table in base-2 logarithms.
+	 * Steps only use 32-bit additions and multiplications, so they are cheap enough for an interrupt service routine,
+	 * and each width is computed from the start of the sweep, so rounding errors do not accumulate.
+	 */
+	class Chirp {
+		public:
+			/// Interpolation of widths between their start and stop values.
+			enum class Shape : uint8_t {
+				Linear,			///< Widths change linearly with time.
+				Exponential		///< Widths change by a constant ratio per unit of time.
+			};
+
+			Chirp();
+
+			/**
+			 * @brief Restart the sweep.
+			 * @param[in] lowStart Width (us) of the low phase at the start.
+			 * @param[in] lowStop Width (us) of the low phase at the end.
+			 * @param[in] highStart Width (us) of the high phase at the start.
+			 * @param[in] highStop Width (us) of the high phase at the end.
+			 * @param[in] duration Duration (us) of the sweep, up to 2^31.
+			 * @param[in] shape Interpolation of widths; exponential sweeps with a width of zero are linear.
+			 */
+			void Setup(uint32_t lowStart, uint32_t lowStop, uint32_t highStart, uint32_t highStop, uint32_t duration, Shape shape);
+
+			/**
+			 * @brief Width of the phase starting now, which is added to the elapsed time.
+			 * @param[in] state State of the phase.
+			 * @return Width (us), at least 1, or 0 once the duration elapsed.
+			 */
+			uint32_t Next(bool state);
+
+		private:
+			struct Sweep {
+				uint32_t start;		///< Width (us) at the start.
+				int32_t change;		///< Linear: stop - start (us). Exponential: log2(stop / start) in Q16.16.
+			};
+
+			uint32_t Width(const Sweep& sweep, uint16_t progress);
+			static int32_t Multiply(int32_t value, uint16_t fraction);
+			static uint32_t Exp2(int32_t exponent, uint32_t value);
+
+			Sweep low;				///< Low phase.
+			Sweep high;				///< High phase.
+			Shape shape;			///< Interpolation of widths.
+			uint32_t duration;		///< Duration (us).
+			uint32_t rate;			///< Reciprocal of the scaled duration, in Q0.32.
+			uint8_t scale;			///< Right shift bringing the duration within 16 bits.
+			uint32_t elapsed;		///< Phase accumulator: time (us) elapsed since the start.
+	};
+}
+
+#endif
@@ -27,7 +27,7 @@ namespace bridge {
 	}
 	
 	void Debounce::Step() {
-		if (changed && micros() >= debounceNext) {
+		if (changed && (int32_t) (micros() - debounceNext) >= 0) {
 			changed = false;
 			// Value debounced.
 			debouncedValue = debouncingValue;
@@ -10,6 +10,7 @@
 #include <Arduino.h>
 #include "DigitalInput.h"
 #include "meta.h"
+#include "PinChange.h"
 #include "tools.h"
 
 namespace bridge {
@@ -20,34 +21,37 @@ namespace bridge {
 	data(data),
 	port(BRIDGE_BASEREG(pin)),
 	mask(BRIDGE_BITMASK(pin)),
-	syncCount(0)
+	overflows(0),
+	tic(0)
 	{
 		// In case the pin is disconnected, a pull-up will keep a stable state.
 		pinMode(pin, INPUT_PULLUP);
+		// Force a report on the first step.
+		bool state = BRIDGE_READ(port, mask);
+		syncState = !state;
+		edges.Push(pin, state);
 		int interruptId = digitalPinToInterrupt(pin);
 		if (interruptId >= 0) {
 			// If an interrupt is available, check states using the service routine instead of the step mechanism.
 			interruptible = true;
-			// Force a report on the first step.
-			asyncCount = 1;
-			asyncState = BRIDGE_READ(port, mask);
-			syncState = !asyncState;
 			/* std is not supported in Arduino and a lambda expression cannot be passed as an argument to
 			   functions when capturing. As a solution, forward from (*void)(void) to (*void)(uintptr_t) 
 			   using a compile-time lookup table (via metaprogramming):
 			 */
 			attachInterrupt(interruptId, meta::Wrap(OnChange, (Data) this), CHANGE);
 		} else {
-			// If an interrupt is not available, use the step mechanism.
-			interruptible = false;
-			// Force a report on the first step.
-			syncState = !BRIDGE_READ(port, mask);
+			// Otherwise, use a pin change interrupt if available, or the step mechanism.
+			interruptible = PinChange::Attach(pin, OnPinChange, (Data) this);
 		}
 	}
 	
 	DigitalInput::~DigitalInput() {
 		// Remove interrupts from this pin.
-		detachInterrupt(digitalPinToInterrupt(pin));
+		int interruptId = digitalPinToInterrupt(pin);
+		if (interruptId >= 0)
+			detachInterrupt(interruptId);
+		else if (interruptible)
+			PinChange::Detach(pin);
 	}
 	
 	void DigitalInput::OnChange(Data data) {
@@ -56,51 +60,43 @@ namespace bridge {
 	}
 	
 	void DigitalInput::OnChange() {
-		asyncState = BRIDGE_READ(port, mask);
-		asyncCount += 1;
+		edges.Push(pin, BRIDGE_READ(port, mask));
+	}
+	
+	void DigitalInput::OnPinChange(Data data, bool state) {
+		((DigitalInput*) data)->edges.Push(((DigitalInput*) data)->pin, state);
 	}
 	
 	void DigitalInput::Step() {
-		bool state;
-		uint32_t count;
-		uint32_t change;
-		// Reconcile count and state from last iteration.
 		if (interruptible) {
-			/* Disable interrupts briefly to safely copy multi-byte data that would
-			   otherwise be at risk of being changed halfways during a copy operation.
-			 */
-			noInterrupts();
-			state = asyncState;
-			count = asyncCount;
-			interrupts();
-			change = count - syncCount;
-		} else {
-			state = BRIDGE_READ(port, mask);
-			if (state == syncState) {
-				change = 0;
-				count = syncCount;
-			} else {
-				change = 1;
-				count = syncCount + 1;
+			// Catch up with pin toggles, one at a time, with the time each one happened.
+			EdgeBuffer<BRIDGE_DIGITALINPUT_EDGES>::Edge edge;
+			while (edges.Pop(edge)) {
+				tic = edge.tic;
+				Toggle();
 			}
-		}
-		// Catch up with pin toggles, one at a time.
-		if (change > 0) {
-			if (function) {
-				for (int c = 0; c < change; c++) {
-					syncState = !syncState;
-					function(this, syncState);
-				}
-			} else {
-				for (int c = 0; c < change; c++) {
-					syncState = !syncState;
-					functionData(this, syncState, data);
-				}
+			// Toggles were lost while the buffer was full; resume from the current state.
+			uint16_t count = edges.GetOverflows();
+			if (count != overflows) {
+				overflows = count;
+				tic = micros();
+				if (BRIDGE_READ(port, mask) != syncState)
+					Toggle();
 			}
-			syncCount = count;
+		} else if (BRIDGE_READ(port, mask) != syncState) {
+			tic = micros();
+			Toggle();
 		}
 	}
 	
+	void DigitalInput::Toggle() {
+		syncState = !syncState;
+		if (function)
+			function(this, syncState);
+		else
+			functionData(this, syncState, data);
+	}
+	
 	bool DigitalInput::GetState() {
 		return syncState;
 	}
@@ -108,4 +104,8 @@ namespace bridge {
 	int8_t DigitalInput::GetPin() {
 		return pin;
 	}
+	
+	uint32_t DigitalInput::GetTic() {
+		return tic;
+	}
 }
\ No newline at end of file
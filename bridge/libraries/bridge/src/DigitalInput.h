@@ -11,14 +11,20 @@
 #define BRIDGE_DIGITALINPUT_H
 
 #include <stdint.h>
+#include "EdgeBuffer.h"
 #include "Stepper.h"
 #include "tools.h"
 
+/// Number of edges buffered between two calls to Step (a power of two).
+#ifndef BRIDGE_DIGITALINPUT_EDGES
+#define BRIDGE_DIGITALINPUT_EDGES 8
+#endif
+
 namespace bridge {
 	/**
 	 * @class DigitalInput
 	 * @brief Setup a GPIO as a digital input with pull-up, listen to digital changes, and report.
-	 * @details If the GPIO has a hardware interrupt, digital changes are captured when triggered.
+	 * @details If the GPIO has an external or pin change interrupt, digital changes are captured when triggered, along with their time.
 	 * The Step method must be called regularly (e.g. from the Arduino loop function) in order to
 	 * report changes promptly and capture changes in the absence of interrupts.
 	 * When possible, the class uses direct port manipulation to access pin state faster than Arduino's digitalRead.
@@ -67,6 +73,9 @@ namespace bridge {
 			/// @return Pin number.
 			int8_t GetPin();
 			
+			/// @return Time (us) at which the change being reported happened; edges captured by an interrupt keep their own time.
+			uint32_t GetTic();
+			
 		private:
 			/**
 			 * @brief Listen and report pin changes. This private constructor is used for two construction delegates.
@@ -88,12 +97,14 @@ namespace bridge {
 			int8_t pin;							///< Pin number the object is processing.
 			static void OnChange(Data data);	///< Call a method from the static context of an interrupt service routine.
 			void OnChange();					///< Recipient method to the static analogous with the same name.
+			static void OnPinChange(Data data, bool state);	///< Call from the pin change interrupt of the pin.
+			void Toggle();						///< Invert the state in the "main thread" and report it.
 			bool interruptible;					///< Whether changes to this pin are captured by an interrupt.
 			
-			uint32_t asyncCount;				///< Count of state changes in the "interrupt thread".
-			bool asyncState;					///< Pin state in the "interrupt thread".
-			uint32_t syncCount;					///< Count of state changes in the "main thread".
+			EdgeBuffer<BRIDGE_DIGITALINPUT_EDGES> edges;	///< Changes captured in the "interrupt thread".
+			uint16_t overflows;					///< Number of changes lost by the "interrupt thread" so far.
 			bool syncState;						///< Pin state in the "main thread".
+			uint32_t tic;						///< Time of the change being reported.
 	};
 }
 
@@ -0,0 +1,90 @@
+/**
+ * @file EdgeBuffer.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Lock-free queue of pin edges captured by interrupt service routines.
+ */
+
+#ifndef BRIDGE_EDGEBUFFER_H
+#define BRIDGE_EDGEBUFFER_H
+
+#include <Arduino.h>
+
+namespace bridge {
+	/**
+	 * @class EdgeBuffer
+	 * @brief Single-producer, single-consumer ring of timestamped pin edges.
+	 * @details Interrupt service routines (the producer) push the time and state of an edge as soon as it
+	 * happens; the main loop (the consumer) pops edges in order from Step. Each side only writes its own
+	 * one-byte index, which the AVR reads and writes atomically, hence neither side disables interrupts.
+	 * On AVR, interrupt service routines do not nest, so all of them may share one buffer as a single producer.
+	 * @tparam size Number of edges; must be a power of two no larger than 128.
+	 */
+	template<uint8_t size>
+	class EdgeBuffer {
+		public:
+			/// @brief An edge captured by an interrupt service routine.
+			struct Edge {
+				uint32_t tic;		///< Time (us) at which the edge was captured.
+				uint8_t pin;		///< Pin or identifier given by the producer.
+				uint8_t state;		///< State read by the producer.
+			};
+
+			EdgeBuffer() : head(0), tail(0), overflows(0) {
+				static_assert(size > 0 && size <= 128 && (size & (size - 1)) == 0, "EdgeBuffer size must be a power of two up to 128.");
+			}
+
+			/**
+			 * @brief Append an edge with the current time. Call from the producer only.
+			 * @param[in] pin Pin or identifier of the source.
+			 * @param[in] state State read from the source.
+			 * @return Whether there was room for the edge; otherwise it is counted as an overflow.
+			 */
+			inline bool Push(uint8_t pin, uint8_t state) {
+				uint8_t next = (tail + 1) & (size - 1);
+				if (next == head) {
+					if (overflows < 0xFFFF)
+						overflows++;
+					return false;
+				}
+				Edge& edge = edges[tail];
+				edge.tic = micros();
+				edge.pin = pin;
+				edge.state = state;
+				tail = next;
+				return true;
+			}
+
+			/**
+			 * @brief Remove the oldest edge. Call from the consumer only.
+			 * @param[out] edge Oldest edge, when available.
+			 * @return Whether an edge was available.
+			 */
+			inline bool Pop(Edge& edge) {
+				uint8_t index = head;
+				if (index == tail)
+					return false;
+				edge = edges[index];
+				head = (index + 1) & (size - 1);
+				return true;
+			}
+
+			/// @return Number of edges lost because the buffer was full.
+			uint16_t GetOverflows() {
+				noInterrupts();
+				uint16_t copy = overflows;
+				interrupts();
+				return copy;
+			}
+
+		private:
+			Edge edges[size];
+			volatile uint8_t head;			///< Index of the oldest edge; written by the consumer.
+			volatile uint8_t tail;			///< Index of the next free slot; written by the producer.
+			volatile uint16_t overflows;	///< Number of edges lost; written by the producer.
+	};
+}
+
+#endif
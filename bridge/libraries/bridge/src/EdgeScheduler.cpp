@@ -0,0 +1,153 @@
+/**
+ * @file EdgeScheduler.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Toggle output pins at their deadlines from a hardware timer compare interrupt.
+ */
+
+#include <Arduino.h>
+#include "EdgeScheduler.h"
+#include "tools.h"
+
+namespace bridge {
+	EdgeScheduler::Channel EdgeScheduler::channels[BRIDGE_SCHEDULER_CHANNELS];
+	uint8_t EdgeScheduler::order[BRIDGE_SCHEDULER_CHANNELS];
+	uint8_t EdgeScheduler::count = 0;
+	volatile uint16_t EdgeScheduler::overflows = 0;
+	bool EdgeScheduler::setup = false;
+	
+	int8_t EdgeScheduler::Start(int8_t pin, bool state, uint32_t width, Function function, Data data) {
+		bool held = width & hold;
+		width &= ~hold;
+		if (width == 0 || width > maxWidth || !Vectors())
+			return -1;
+		uint8_t id;
+		for (id = 0; id < BRIDGE_SCHEDULER_CHANNELS && channels[id].used; id++) {}
+		if (id == BRIDGE_SCHEDULER_CHANNELS)
+			return -1;
+		Setup();
+		
+		Channel& channel = channels[id];
+		channel.port = BRIDGE_BASEREG(pin);
+		channel.mask = BRIDGE_BITMASK(pin);
+		channel.state = state;
+		channel.hold = held;
+		channel.function = function;
+		channel.data = data;
+		channel.used = true;
+		noInterrupts();
+		channel.deadline = Now() + width * ticksPerUs;
+		Insert(id);
+		Service();
+		interrupts();
+		return id;
+	}
+	
+	void EdgeScheduler::Stop(int8_t id) {
+		if (id < 0 || id >= BRIDGE_SCHEDULER_CHANNELS)
+			return;
+		noInterrupts();
+		if (channels[id].active)
+			Remove(id);
+		channels[id].used = false;
+		Service();
+		interrupts();
+	}
+	
+	bool EdgeScheduler::IsRunning(int8_t id) {
+		return id >= 0 && id < BRIDGE_SCHEDULER_CHANNELS && channels[id].active;
+	}
+	
+	uint32_t EdgeScheduler::Now() {
+		uint8_t sreg = SREG;
+		noInterrupts();
+		uint16_t low = BRIDGE_SCHEDULER_REG(TCNT, );
+		uint16_t high = overflows;
+		// An overflow not serviced yet, because interrupts are disabled.
+		if ((BRIDGE_SCHEDULER_REG(TIFR, ) & _BV(BRIDGE_SCHEDULER_REG(TOV, ))) && low < 0x8000)
+			high++;
+		SREG = sreg;
+		return ((uint32_t) high << 16) | low;
+	}
+	
+	void EdgeScheduler::Service() {
+		while (count > 0) {
+			uint8_t id = order[0];
+			Channel& channel = channels[id];
+			if ((int32_t) (channel.deadline - Now()) > 0) {
+				// Compare matches on the low word; a deadline further away wakes up early and re-arms.
+				BRIDGE_SCHEDULER_REG(OCR, A) = (uint16_t) channel.deadline;
+				BRIDGE_SCHEDULER_REG(TIFR, ) = _BV(BRIDGE_SCHEDULER_REG(OCF, A));
+				BRIDGE_SCHEDULER_REG(TIMSK, ) |= _BV(BRIDGE_SCHEDULER_REG(OCIE, A));
+				// A deadline reached while arming is served right away.
+				if ((int32_t) (channel.deadline - Now()) > 0)
+					return;
+				continue;
+			}
+			Remove(id);
+			if (!channel.hold) {
+				channel.state = !channel.state;
+				if (channel.state)
+					BRIDGE_WRITE_HIGH(channel.port, channel.mask);
+				else
+					BRIDGE_WRITE_LOW(channel.port, channel.mask);
+			}
+			// Next edge is scheduled from the ideal time of this one.
+			uint32_t width = channel.function(channel.data, channel.state);
+			channel.hold = width & hold;
+			width &= ~hold;
+			if (width > 0 && width <= maxWidth) {
+				channel.deadline += width * ticksPerUs;
+				Insert(id);
+			}
+		}
+		BRIDGE_SCHEDULER_REG(TIMSK, ) &= ~_BV(BRIDGE_SCHEDULER_REG(OCIE, A));
+	}
+	
+	void EdgeScheduler::Overflow() {
+		overflows++;
+	}
+	
+	void EdgeScheduler::Setup() {
+		if (setup)
+			return;
+		setup = true;
+		noInterrupts();
+		// Normal mode, prescaler 8.
+		BRIDGE_SCHEDULER_REG(TCCR, A) = 0;
+		BRIDGE_SCHEDULER_REG(TCCR, B) = _BV(BRIDGE_SCHEDULER_REG(CS, 1));
+		BRIDGE_SCHEDULER_REG(TCNT, ) = 0;
+		BRIDGE_SCHEDULER_REG(TIFR, ) = _BV(BRIDGE_SCHEDULER_REG(TOV, )) | _BV(BRIDGE_SCHEDULER_REG(OCF, A));
+		BRIDGE_SCHEDULER_REG(TIMSK, ) = _BV(BRIDGE_SCHEDULER_REG(TOIE, ));
+		interrupts();
+	}
+	
+	// Keep active channels sorted by deadline; deadlines are compared relative to each other to survive wraps.
+	void EdgeScheduler::Insert(uint8_t id) {
+		uint32_t deadline = channels[id].deadline;
+		uint8_t i = count;
+		while (i > 0 && (int32_t) (channels[order[i - 1]].deadline - deadline) > 0) {
+			order[i] = order[i - 1];
+			i--;
+		}
+		order[i] = id;
+		count++;
+		channels[id].active = true;
+	}
+	
+	void EdgeScheduler::Remove(uint8_t id) {
+		uint8_t i;
+		for (i = 0; i < count && order[i] != id; i++) {}
+		for (; i + 1 < count; i++)
+			order[i] = order[i + 1];
+		count--;
+		channels[id].active = false;
+	}
+	
+	// Replaced by the definition in BRIDGE_SCHEDULER_VECTORS.
+	__attribute__((weak)) bool EdgeScheduler::Vectors() {
+		return false;
+	}
+}
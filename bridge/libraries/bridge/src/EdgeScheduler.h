@@ -0,0 +1,133 @@
+/**
+ * @file EdgeScheduler.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Toggle output pins at their deadlines from a hardware timer compare interrupt.
+ */
+
+#ifndef BRIDGE_EDGESCHEDULER_H
+#define BRIDGE_EDGESCHEDULER_H
+
+#include <Arduino.h>
+
+/// 16-bit timer dedicated to the scheduler (Timer3, Timer4 or Timer5 on the Mega, Timer1 elsewhere).
+#ifndef BRIDGE_SCHEDULER_TIMER
+	#if defined(TCCR5A)
+		#define BRIDGE_SCHEDULER_TIMER 5
+	#else
+		#define BRIDGE_SCHEDULER_TIMER 1
+	#endif
+#endif
+
+// Registers and bits of the scheduler timer, e.g. BRIDGE_SCHEDULER_REG(TCCR, B) is TCCR5B for Timer5.
+#define BRIDGE_SCHEDULER_CAT(a, n, b) a##n##b
+#define BRIDGE_SCHEDULER_EXPAND(a, n, b) BRIDGE_SCHEDULER_CAT(a, n, b)
+#define BRIDGE_SCHEDULER_REG(a, b) BRIDGE_SCHEDULER_EXPAND(a, BRIDGE_SCHEDULER_TIMER, b)
+
+/// Number of outputs scheduled at once.
+#ifndef BRIDGE_SCHEDULER_CHANNELS
+#define BRIDGE_SCHEDULER_CHANNELS 8
+#endif
+
+namespace bridge {
+	/**
+	 * @class EdgeScheduler
+	 * @brief Queue of output edges sorted by deadline, served by a timer compare interrupt.
+	 * @details The timer runs with a prescaler of 8 (0.5us per tick at 16 MHz), and its overflows extend it to
+	 * a 32-bit time base. The compare register is armed for the earliest pending edge; its service routine writes
+	 * the pin directly, unless the phase that ended was marked with hold, then asks the owner of the channel for
+	 * the duration of the phase that just started, and
+	 * schedules the next edge from the ideal time of the previous one, so that phase errors do not accumulate.
+	 * Output timing is therefore independent of the main loop, except for the latency of other interrupts.
+	 * Once started, takes over the timer, hence analogWrite is not available on its pins (44 to 46 with Timer5 on the Mega,
+	 * 9 and 10 with Timer1 on the Uno), and it cannot be combined with libraries using it (e.g. Servo on Timer5).
+	 * The overflow and compare A service routines of that timer are only defined by sketches expanding
+	 * BRIDGE_SCHEDULER_VECTORS; until then, Start fails and callers toggle their pins themselves.
+	 */
+	class EdgeScheduler {
+		public:
+			/// @typedef User data to include during a callback.
+			typedef uintptr_t Data;
+			
+			/**
+			 * @typedef Function invoked from the interrupt context right after the pin was written (or held).
+			 * Returns the duration (us) of the phase started with the given state, or 0 to end the schedule.
+			 * The duration may be or-ed with hold.
+			 */
+			typedef uint32_t (*Function) (Data data, bool state);
+			
+			/// Number of timer ticks per microsecond.
+			static const uint8_t ticksPerUs = F_CPU / 8000000UL;
+			
+			/// Longest phase (us) that can be scheduled.
+			static const uint32_t maxWidth = 0x7FFFFFFFUL / ticksPerUs;
+			
+			/// Flag or-ed with the duration of a phase so that the pin keeps its state, instead of toggling, when it ends.
+			static const uint32_t hold = 0x80000000UL;
+			
+			/**
+			 * @brief Toggle a pin at the end of each phase, starting with a phase of the given state and width.
+			 * @param[in] pin GPIO number, already an output written with the given state.
+			 * @param[in] state State of the pin during the first phase.
+			 * @param[in] width Duration (us) of the first phase, between 1 and maxWidth, optionally or-ed with hold.
+			 * @param[in] function Function giving the duration of each following phase.
+			 * @param[in] data User data to include in the callback.
+			 * @return Channel running the schedule, or -1 when none is available or the service routines are not defined.
+			 */
+			static int8_t Start(int8_t pin, bool state, uint32_t width, Function function, Data data);
+			
+			/**
+			 * @brief Cancel the pending edge of a channel and release it.
+			 * @param[in] channel Channel returned by Start; ignored when negative.
+			 */
+			static void Stop(int8_t channel);
+			
+			/// @return Whether the channel has a pending edge.
+			static bool IsRunning(int8_t channel);
+			
+			/// @return Time in timer ticks.
+			static uint32_t Now();
+			
+			/// @brief Write due edges and arm the timer for the next one; invoked by the compare service routine.
+			static void Service();
+			
+			/// @brief Extend the time base; invoked by the overflow service routine.
+			static void Overflow();
+			
+			/// @return Whether the sketch defined the service routines (see BRIDGE_SCHEDULER_VECTORS).
+			static bool Vectors();
+			
+		private:
+			struct Channel {
+				uint32_t deadline;			///< Time (ticks) of the next edge.
+				volatile uint8_t* port;		///< Input register of the pin; the output register follows it.
+				uint8_t mask;				///< Mask of the pin.
+				bool state;					///< Current state of the pin.
+				bool hold;					///< Whether the pin keeps its state at the next edge.
+				bool used;					///< Whether the channel belongs to a caller of Start.
+				bool active;				///< Whether an edge is pending.
+				Function function;			///< Duration of each phase.
+				Data data;					///< User data.
+			};
+			
+			static void Setup();
+			static void Insert(uint8_t id);
+			static void Remove(uint8_t id);
+			
+			static Channel channels[BRIDGE_SCHEDULER_CHANNELS];
+			static uint8_t order[BRIDGE_SCHEDULER_CHANNELS];	///< Active channels, earliest deadline first.
+			static uint8_t count;								///< Number of active channels.
+			static volatile uint16_t overflows;					///< High word of the time base.
+			static bool setup;									///< Whether the timer was configured.
+	};
+}
+
+/// Define the service routines of EdgeScheduler; expand once, at global scope, in a sketch that lets it use them.
+#define BRIDGE_SCHEDULER_VECTORS \
+	bool bridge::EdgeScheduler::Vectors() {return true;} \
+	ISR(BRIDGE_SCHEDULER_REG(TIMER, _COMPA_vect)) {bridge::EdgeScheduler::Service();} \
+	ISR(BRIDGE_SCHEDULER_REG(TIMER, _OVF_vect)) {bridge::EdgeScheduler::Overflow();}
+
+#endif
@@ -9,6 +9,8 @@ namespace bridge {
 			Infinite repetitions is accomplished by setting phases to zero.
 			The final state is forced when the oscillator is stopped.
 		*/
+		EdgeScheduler::Stop(channel);
+		channel = -1;
 		this->pin = pin;
 		this->stateStart = state;
 		this->state = state,
@@ -36,23 +38,42 @@ namespace bridge {
 			state = !stateStart;
 			epoch = Epochs::Running;
 			if (delay == 0) {
-				next = 0;
+				Toggle();
+				next = tic + (state ? durationHigh : durationLow);
 			} else {
 				Write(state);
 				next = tic + delay;
 			}
+			// Let the timer toggle the pin when durations fit; otherwise toggle it from here.
+			if (epoch == Epochs::Running && durationLow > 0 && durationHigh > 0 && max(durationLow, durationHigh) <= EdgeScheduler::maxWidth)
+				channel = EdgeScheduler::Start(pin, state, next - tic, OnEdge, (EdgeScheduler::Data) this);
+		} else if (epoch == Epochs::Running && channel < 0 && (int32_t) (tic - next) >= 0) {
+			Toggle();
+			// Next phase change is relative to the ideal time of this one.
+			next += state ? durationHigh : durationLow;
 		}
-		if (epoch == Epochs::Running) {
-			if (tic >= next) {
-				if (finite)
-					phases -= 1;
-				if (phases == 0)
-					epoch = Epochs::Idle;				
-				state = !state;
-				Write(state);
-				next = tic + (state ? durationHigh : durationLow);
-			}
+	}
+	
+	void Oscillator::Toggle() {
+		if (finite)
+			phases -= 1;
+		if (phases == 0)
+			epoch = Epochs::Idle;
+		state = !state;
+		Write(state);
+	}
+	
+	// Edge written by the scheduler; runs in the interrupt context.
+	uint32_t Oscillator::OnEdge(EdgeScheduler::Data data, bool state) {
+		Oscillator* self = (Oscillator*) data;
+		self->state = state;
+		if (self->finite)
+			self->phases -= 1;
+		if (self->phases == 0) {
+			self->epoch = Epochs::Idle;
+			return 0;
 		}
+		return state ? self->durationHigh : self->durationLow;
 	}
 	
 	int8_t Oscillator::GetPin() {
@@ -71,6 +92,8 @@ namespace bridge {
 	}
 	
 	void Oscillator::Stop() {
+		EdgeScheduler::Stop(channel);
+		channel = -1;
 		bool finalState = (phases % 2 == 0) ? !stateStart : stateStart;
 		if (state != finalState)
 			Write(finalState);
@@ -2,6 +2,7 @@
 #define BRIDGE_Oscillator_H
 
 #include <stdint.h>
+#include "EdgeScheduler.h"
 #include "Stepper.h"
 #include "tools.h"
 
@@ -21,7 +22,7 @@ namespace bridge {
 				Setup,
 				Running
 			};
-			Epochs epoch;
+			volatile Epochs epoch;
 			volatile BRIDGE_IO_REG_TYPE* port;	///< Hardware address of the pin.
 			BRIDGE_IO_REG_TYPE mask;			///< Mask to single out in the hardware address.
 			int8_t pin;							///< Pin id in hardware.
@@ -32,8 +33,11 @@ namespace bridge {
 			uint32_t delay;						///<
 			uint32_t durationLow;				///< Duration of low phase.
 			uint32_t durationHigh;				///< Duration of high phase.
-			uint32_t phases;					///< Phase control.
+			volatile uint32_t phases;			///< Phase control.
+			int8_t channel = -1;				///< Scheduler channel toggling the pin, if any.
 			void Write(bool state);
+			void Toggle();
+			static uint32_t OnEdge(EdgeScheduler::Data data, bool state);
 			
 	};
 }
@@ -0,0 +1,83 @@
+/**
+ * @file PinChange.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Listen to changes of pins without an external interrupt using pin change interrupts (PCINT).
+ */
+
+#include <Arduino.h>
+#include "PinChange.h"
+
+namespace bridge {
+	PinChange::Bank PinChange::banks[BRIDGE_PINCHANGE_BANKS];
+	
+	bool PinChange::Attach(int8_t pin, Function function, Data data) {
+		volatile uint8_t* pcicr = digitalPinToPCICR(pin);
+		if (pcicr == nullptr || !Vectors())
+			return false;
+		uint8_t b = digitalPinToPCICRbit(pin);
+		if (b >= BRIDGE_PINCHANGE_BANKS)
+			return false;
+		Bank& bank = banks[b];
+		volatile uint8_t* port = portInputRegister(digitalPinToPort(pin));
+		uint8_t mask = digitalPinToBitMask(pin);
+		// A bank reads a single port.
+		if (bank.enabled != 0 && bank.port != port)
+			return false;
+		uint8_t bit = 0;
+		while ((mask >> bit) != 1)
+			bit++;
+		
+		noInterrupts();
+		bank.port = port;
+		bank.functions[bit] = function;
+		bank.data[bit] = data;
+		// Changes before attaching are not reported.
+		bank.last = (bank.last & ~mask) | (*port & mask);
+		bank.enabled |= mask;
+		*digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+		*pcicr |= _BV(b);
+		interrupts();
+		return true;
+	}
+	
+	void PinChange::Detach(int8_t pin) {
+		volatile uint8_t* pcicr = digitalPinToPCICR(pin);
+		if (pcicr == nullptr)
+			return;
+		uint8_t b = digitalPinToPCICRbit(pin);
+		if (b >= BRIDGE_PINCHANGE_BANKS)
+			return;
+		Bank& bank = banks[b];
+		volatile uint8_t* pcmsk = digitalPinToPCMSK(pin);
+		uint8_t mask = digitalPinToBitMask(pin);
+		if (bank.port != portInputRegister(digitalPinToPort(pin)))
+			return;
+		
+		noInterrupts();
+		*pcmsk &= ~_BV(digitalPinToPCMSKbit(pin));
+		bank.enabled &= ~mask;
+		if (*pcmsk == 0)
+			*pcicr &= ~_BV(b);
+		interrupts();
+	}
+	
+	void PinChange::Dispatch(uint8_t b) {
+		Bank& bank = banks[b];
+		uint8_t snapshot = *bank.port;
+		uint8_t changed = (snapshot ^ bank.last) & bank.enabled;
+		bank.last = snapshot;
+		// Cost is proportional to the position of the highest changed bit.
+		for (uint8_t bit = 0; changed; bit++, changed >>= 1, snapshot >>= 1) {
+			if (changed & 1)
+				bank.functions[bit](bank.data[bit], snapshot & 1);
+		}
+	}
+	
+	// Replaced by the definition in BRIDGE_PINCHANGE_VECTORS.
+	__attribute__((weak)) bool PinChange::Vectors() {
+		return false;
+	}
+}
@@ -0,0 +1,94 @@
+/**
+ * @file PinChange.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Listen to changes of pins without an external interrupt using pin change interrupts (PCINT).
+ */
+
+#ifndef BRIDGE_PINCHANGE_H
+#define BRIDGE_PINCHANGE_H
+
+#include <Arduino.h>
+
+/// Number of pin change interrupt banks (PCMSK registers) handled.
+#define BRIDGE_PINCHANGE_BANKS 3
+
+namespace bridge {
+	/**
+	 * @class PinChange
+	 * @brief Dispatch pin change interrupts to a function registered per pin.
+	 * @details Pins share one interrupt per bank (PCMSK register). The service routine of a bank reads
+	 * its port once, XORs it against the previous snapshot to find which registered pins changed, and invokes
+	 * their functions with the new state, from the interrupt context. The pins of a bank must belong to a single
+	 * port, which is the case on the standard (Uno) and mega variants except for bank 1 on the Mega.
+	 * The PCINT0, PCINT1 and PCINT2 service routines are only defined by sketches expanding BRIDGE_PINCHANGE_VECTORS,
+	 * which then cannot be combined with other libraries defining them (e.g. SoftwareSerial); until then, Attach fails.
+	 */
+	class PinChange {
+		public:
+			/// @typedef User data to include during a callback.
+			typedef uintptr_t Data;
+			
+			/// @typedef Function to invoke from the interrupt context when a pin changes.
+			typedef void (*Function) (Data data, bool state);
+			
+			/**
+			 * @brief Invoke function(data, state) when the pin changes.
+			 * @param[in] pin GPIO number.
+			 * @param[in] function Function to invoke on change.
+			 * @param[in] data User data to include in the callback.
+			 * @return Whether the pin has a pin change interrupt that could be used, and its service routine is defined.
+			 */
+			static bool Attach(int8_t pin, Function function, Data data);
+			
+			/**
+			 * @brief Stop listening to a pin.
+			 * @param[in] pin GPIO number.
+			 */
+			static void Detach(int8_t pin);
+			
+			/// @brief Service a bank; invoked by the interrupt service routines.
+			static void Dispatch(uint8_t bank);
+			
+			/// @return Whether the sketch defined the service routines (see BRIDGE_PINCHANGE_VECTORS).
+			static bool Vectors();
+			
+		private:
+			struct Bank {
+				volatile uint8_t* port;		///< Input register shared by the pins of the bank.
+				uint8_t last;				///< Port snapshot from the previous interrupt.
+				uint8_t enabled;			///< Port bits of the registered pins.
+				Function functions[8];		///< Function per port bit.
+				Data data[8];				///< User data per port bit.
+			};
+			static Bank banks[BRIDGE_PINCHANGE_BANKS];
+	};
+}
+
+// Service routine of each bank, when the bank exists.
+#if defined(PCINT0_vect)
+	#define BRIDGE_PINCHANGE_VECTOR0 ISR(PCINT0_vect) {bridge::PinChange::Dispatch(0);}
+#else
+	#define BRIDGE_PINCHANGE_VECTOR0
+#endif
+#if defined(PCINT1_vect)
+	#define BRIDGE_PINCHANGE_VECTOR1 ISR(PCINT1_vect) {bridge::PinChange::Dispatch(1);}
+#else
+	#define BRIDGE_PINCHANGE_VECTOR1
+#endif
+#if defined(PCINT2_vect)
+	#define BRIDGE_PINCHANGE_VECTOR2 ISR(PCINT2_vect) {bridge::PinChange::Dispatch(2);}
+#else
+	#define BRIDGE_PINCHANGE_VECTOR2
+#endif
+
+/// Define the service routines of PinChange; expand once, at global scope, in a sketch that lets it use them.
+#define BRIDGE_PINCHANGE_VECTORS \
+	bool bridge::PinChange::Vectors() {return true;} \
+	BRIDGE_PINCHANGE_VECTOR0 \
+	BRIDGE_PINCHANGE_VECTOR1 \
+	BRIDGE_PINCHANGE_VECTOR2
+
+#endif
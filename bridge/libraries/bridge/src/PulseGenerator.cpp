@@ -0,0 +1,201 @@
+/**
+ * @file PulseGenerator.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Generate pulse trains in hardware on the output compare pins of 16-bit timers.
+ */
+
+#include <Arduino.h>
+#include "PulseGenerator.h"
+#include "tools.h"
+
+// Registers of a timer, in the order of PulseGenerator::Timer.
+#define BRIDGE_PULSE_TIMER(n) {TIMER##n##A, &TCCR##n##A, &TCCR##n##B, &TCCR##n##C, &TIMSK##n, &TIFR##n, &TCNT##n, &ICR##n, &OCR##n##A}
+
+namespace bridge {
+	PulseGenerator::Timer PulseGenerator::timers[PulseGenerator::nTimers] = {
+		#if defined(BRIDGE_PULSE_TIMER1)
+			BRIDGE_PULSE_TIMER(1),
+		#else
+			{},
+		#endif
+		#if defined(BRIDGE_PULSE_TIMER3)
+			BRIDGE_PULSE_TIMER(3),
+		#else
+			{},
+		#endif
+		#if defined(BRIDGE_PULSE_TIMER4)
+			BRIDGE_PULSE_TIMER(4),
+		#else
+			{},
+		#endif
+		#if defined(BRIDGE_PULSE_TIMER5)
+			BRIDGE_PULSE_TIMER(5),
+		#else
+			{},
+		#endif
+	};
+
+	int8_t PulseGenerator::Start(int8_t pin, bool state, uint32_t first, uint32_t second, uint32_t repetitions) {
+		// Timer wired to the pin.
+		uint8_t output = digitalPinToTimer(pin);
+		uint8_t id;
+		for (id = 0; id < nTimers && !(timers[id].tccrA && output >= timers[id].output && output < timers[id].output + 3); id++) {}
+		if (id == nTimers || timers[id].used)
+			return -1;
+		uint8_t clock;
+		uint16_t firstTicks;
+		uint16_t top;
+		if (!Fit(first, second, clock, firstTicks, top) || (repetitions > 0 && (first + second < minPeriod || !Vectors())))
+			return -1;
+
+		Timer& timer = timers[id];
+		uint8_t channel = output - timer.output;
+		// Compare output mode bits of the channel: A is at bits 7:6, B at 5:4 and C at 3:2.
+		uint8_t shift = 6 - 2 * channel;
+		timer.port = BRIDGE_BASEREG(pin);
+		timer.mask = BRIDGE_BITMASK(pin);
+		timer.stateEnd = !state;
+		timer.used = true;
+		timer.running = true;
+		timer.last = repetitions == 1;
+		timer.remaining = repetitions > 0 ? repetitions - 1 : 0;
+
+		uint8_t sreg = SREG;
+		noInterrupts();
+		// Stop the timer in normal mode, where compare registers are not buffered.
+		*timer.tccrB = 0;
+		*timer.tccrA = 0;
+		*timer.timsk = 0;
+		*timer.tcnt = 0;
+		*timer.icr = top;
+		timer.ocr[channel] = firstTicks - 1;
+		// Force the output to the first state while the pin is an input, as recommended by the datasheet.
+		*(timer.port + 1) &= ~timer.mask;
+		*timer.tccrA = (state ? 3 : 2) << shift;
+		*timer.tccrC = 0x80 >> channel;
+		*(timer.port + 1) |= timer.mask;
+		// Non-inverting output starts high, inverting output starts low; both change at the compare match.
+		uint8_t mode = (state ? 2 : 3) << shift;
+		if (repetitions > 0) {
+			*timer.tifr = _BV(TOV1);
+			*timer.timsk = _BV(TOIE1);
+		}
+		if (timer.last) {
+			// Single period in normal mode.
+			*timer.tccrA = mode;
+			*timer.tccrB = clock;
+		} else {
+			// Fast PWM with TOP at ICRn.
+			*timer.tccrA = mode | _BV(WGM11);
+			*timer.tccrB = _BV(WGM13) | _BV(WGM12) | clock;
+		}
+		SREG = sreg;
+		return id;
+	}
+
+	void PulseGenerator::Stop(int8_t id) {
+		if (id < 0 || id >= nTimers || !timers[id].used)
+			return;
+		Timer& timer = timers[id];
+		uint8_t sreg = SREG;
+		noInterrupts();
+		// Hold the pin at its current state once disconnected from the timer.
+		if (BRIDGE_READ(timer.port, timer.mask))
+			BRIDGE_WRITE_HIGH(timer.port, timer.mask);
+		else
+			BRIDGE_WRITE_LOW(timer.port, timer.mask);
+		Restore(timer);
+		timer.running = false;
+		SREG = sreg;
+	}
+
+	bool PulseGenerator::IsRunning(int8_t id) {
+		return id >= 0 && id < nTimers && timers[id].running;
+	}
+
+	bool PulseGenerator::Reserve(uint8_t number) {
+		int8_t id = Find(number);
+		if (id < 0 || !timers[id].tccrA || timers[id].used)
+			return false;
+		timers[id].used = true;
+		return true;
+	}
+
+	void PulseGenerator::Free(uint8_t number) {
+		int8_t id = Find(number);
+		if (id < 0 || !timers[id].used || timers[id].running)
+			return;
+		uint8_t sreg = SREG;
+		noInterrupts();
+		Restore(timers[id]);
+		SREG = sreg;
+	}
+
+	void PulseGenerator::Overflow(uint8_t id) {
+		Timer& timer = timers[id];
+		if (timer.last) {
+			// The last edge was written; hold the pin at its final state and stop.
+			*timer.tccrB = 0;
+			if (timer.stateEnd)
+				BRIDGE_WRITE_HIGH(timer.port, timer.mask);
+			else
+				BRIDGE_WRITE_LOW(timer.port, timer.mask);
+			*timer.tccrA = 0;
+			*timer.timsk = 0;
+			timer.running = false;
+		} else if (--timer.remaining == 0) {
+			// The last period started; in normal mode the output changes at the compare match but is not restored at TOP.
+			*timer.tccrA &= ~(_BV(WGM11) | _BV(WGM10));
+			*timer.tccrB &= ~(_BV(WGM13) | _BV(WGM12));
+			timer.last = true;
+		}
+	}
+
+	// Index of a timer in the table.
+	int8_t PulseGenerator::Find(uint8_t number) {
+		switch (number) {
+			case 1: return 0;
+			case 3: return 1;
+			case 4: return 2;
+			case 5: return 3;
+			default: return -1;
+		}
+	}
+
+	// Configuration of the Arduino core: 8-bit phase correct PWM, prescaler 64.
+	void PulseGenerator::Restore(Timer& timer) {
+		*timer.timsk = 0;
+		*timer.tccrA = _BV(WGM10);
+		*timer.tccrB = _BV(CS11) | _BV(CS10);
+		timer.used = false;
+	}
+
+	// Smallest prescaler giving an exact number of ticks to both phases, within 16 bits.
+	bool PulseGenerator::Fit(uint32_t first, uint32_t second, uint8_t &clock, uint16_t &firstTicks, uint16_t &top) {
+		static const uint16_t divisors[] = {1, 8, 64, 256, 1024};
+		const uint32_t cyclesPerUs = F_CPU / 1000000UL;
+		if (first == 0 || second == 0 || first > maxPeriod || second > maxPeriod - first)
+			return false;
+		for (uint8_t i = 0; i < 5; i++) {
+			uint16_t divisor = divisors[i];
+			uint32_t cycles1 = first * cyclesPerUs;
+			uint32_t cycles = (first + second) * cyclesPerUs;
+			if (cycles1 % divisor == 0 && cycles % divisor == 0 && cycles / divisor <= 0x10000UL) {
+				// Clock select bits CSn2:0 are 1 to 5 for these divisors.
+				clock = i + 1;
+				firstTicks = cycles1 / divisor;
+				top = cycles / divisor - 1;
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	// Replaced by the definition in BRIDGE_PULSE_VECTORS.
+	__attribute__((weak)) bool PulseGenerator::Vectors() {
+		return false;
+	}
+}
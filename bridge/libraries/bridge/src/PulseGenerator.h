@@ -0,0 +1,151 @@
+/**
+ * @file PulseGenerator.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ *
+ * @brief Generate pulse trains in hardware on the output compare pins of 16-bit timers.
+ */
+
+#ifndef BRIDGE_PULSEGENERATOR_H
+#define BRIDGE_PULSEGENERATOR_H
+
+#include <Arduino.h>
+#include "EdgeScheduler.h"
+#include "tools.h"
+
+// Timers available to pulse trains: 16-bit timers other than the one of EdgeScheduler.
+#if defined(TCCR1A) && BRIDGE_SCHEDULER_TIMER != 1
+	#define BRIDGE_PULSE_TIMER1
+#endif
+#if defined(TCCR3A) && BRIDGE_SCHEDULER_TIMER != 3
+	#define BRIDGE_PULSE_TIMER3
+#endif
+#if defined(TCCR4A) && BRIDGE_SCHEDULER_TIMER != 4
+	#define BRIDGE_PULSE_TIMER4
+#endif
+#if defined(TCCR5A) && BRIDGE_SCHEDULER_TIMER != 5
+	#define BRIDGE_PULSE_TIMER5
+#endif
+
+namespace bridge {
+	/**
+	 * @class PulseGenerator
+	 * @brief Pulse trains written by the waveform generator of a 16-bit timer.
+	 * @details Pins wired to an output compare unit (OCnA, OCnB or OCnC; see digitalPinToTimer) of a timer other
+	 * than the one of EdgeScheduler are driven by the timer itself in fast PWM mode, with TOP set to the period and
+	 * the compare register to the end of the first phase, hence edges cost no CPU time and land on the clock cycle
+	 * (62.5 ns at 16 MHz) when the prescaler is 1. The smallest prescaler (1, 8, 64, 256 or 1024) representing both
+	 * phases exactly, within a period of 65536 ticks, is chosen.
+	 * Finite trains count periods with the overflow interrupt of the timer; the last period runs in normal mode so
+	 * that the output is not restored once it ends, hence periods must last at least minPeriod.
+	 * A timer serves one pin at a time; while in use, analogWrite is not available on its other pins. Released
+	 * timers are restored to the configuration of the Arduino core. The overflow service routines of the timers it
+	 * may use (Timer1, Timer3 and Timer4 on the Mega; none on the Uno, where Timer1 belongs to EdgeScheduler) are only
+	 * defined by sketches expanding BRIDGE_PULSE_VECTORS; until then, finite trains are refused. Other users of these timers reserve them first (see Reserve).
+	 */
+	class PulseGenerator {
+		public:
+			/// Shortest period (us) of a finite train.
+			static const uint32_t minPeriod = 32;
+
+			/// Longest period (us), with the largest prescaler.
+			static const uint32_t maxPeriod = 0x10000UL * 1024 / (F_CPU / 1000000UL);
+
+			/**
+			 * @brief Generate a pulse train on a pin when a timer is available for it and the durations fit.
+			 * @param[in] pin GPIO number, already an output written with the given state.
+			 * @param[in] state State of the pin during the first phase of each period.
+			 * @param[in] first Duration (us) of the first phase.
+			 * @param[in] second Duration (us) of the second phase.
+			 * @param[in] repetitions Number of periods, or 0 to repeat forever; the pin holds the second state after the last.
+			 * @return Generator running the train, or -1 when the pin cannot be driven by a timer, or when the train is
+			 * finite and the service routines are not defined.
+			 */
+			static int8_t Start(int8_t pin, bool state, uint32_t first, uint32_t second, uint32_t repetitions);
+
+			/**
+			 * @brief Stop a train, hold the pin at its current state, and release the timer.
+			 * @param[in] id Generator returned by Start; ignored when negative.
+			 */
+			static void Stop(int8_t id);
+
+			/// @return Whether the train of a generator has not ended.
+			static bool IsRunning(int8_t id);
+
+			/**
+			 * @brief Keep a timer from generating pulse trains, e.g. while it triggers the ADC.
+			 * @param[in] number Timer number (1, 3, 4 or 5).
+			 * @return Whether the timer is available to pulse trains and was not in use.
+			 */
+			static bool Reserve(uint8_t number);
+
+			/// @brief Release a reserved timer, restored to the configuration of the Arduino core.
+			static void Free(uint8_t number);
+
+			/// @brief Count a period; invoked by the overflow service routine of the timer.
+			static void Overflow(uint8_t id);
+
+			/// @return Whether the sketch defined the service routines (see BRIDGE_PULSE_VECTORS).
+			static bool Vectors();
+
+		private:
+			struct Timer {
+				uint8_t output;						///< Code of output A in digitalPinToTimer (e.g. TIMER1A); B and C follow.
+				volatile uint8_t* tccrA;			///< Control register A.
+				volatile uint8_t* tccrB;			///< Control register B.
+				volatile uint8_t* tccrC;			///< Control register C.
+				volatile uint8_t* timsk;			///< Interrupt mask register.
+				volatile uint8_t* tifr;				///< Interrupt flag register.
+				volatile uint16_t* tcnt;			///< Counter.
+				volatile uint16_t* icr;				///< Input capture register, used as TOP.
+				volatile uint16_t* ocr;				///< Compare register A; B and C follow.
+				volatile uint8_t* port;				///< Input register of the pin; the output register follows it.
+				uint8_t mask;						///< Mask of the pin.
+				bool stateEnd;						///< State of the pin after the last period.
+				bool used;							///< Whether the timer belongs to a caller of Start.
+				volatile bool running;				///< Whether the train has not ended.
+				volatile bool last;					///< Whether the last period started.
+				volatile uint32_t remaining;		///< Periods left before the last one.
+			};
+
+			static int8_t Find(uint8_t number);
+			static void Restore(Timer& timer);
+			static bool Fit(uint32_t first, uint32_t second, uint8_t &clock, uint16_t &firstTicks, uint16_t &top);
+
+			static const uint8_t nTimers = 4;
+			static Timer timers[nTimers];			///< Timer1, Timer3, Timer4 and Timer5, when available.
+	};
+}
+
+// Overflow service routine of each timer available to pulse trains.
+#if defined(BRIDGE_PULSE_TIMER1)
+	#define BRIDGE_PULSE_VECTOR1 ISR(TIMER1_OVF_vect) {bridge::PulseGenerator::Overflow(0);}
+#else
+	#define BRIDGE_PULSE_VECTOR1
+#endif
+#if defined(BRIDGE_PULSE_TIMER3)
+	#define BRIDGE_PULSE_VECTOR3 ISR(TIMER3_OVF_vect) {bridge::PulseGenerator::Overflow(1);}
+#else
+	#define BRIDGE_PULSE_VECTOR3
+#endif
+#if defined(BRIDGE_PULSE_TIMER4)
+	#define BRIDGE_PULSE_VECTOR4 ISR(TIMER4_OVF_vect) {bridge::PulseGenerator::Overflow(2);}
+#else
+	#define BRIDGE_PULSE_VECTOR4
+#endif
+#if defined(BRIDGE_PULSE_TIMER5)
+	#define BRIDGE_PULSE_VECTOR5 ISR(TIMER5_OVF_vect) {bridge::PulseGenerator::Overflow(3);}
+#else
+	#define BRIDGE_PULSE_VECTOR5
+#endif
+
+/// Define the service routines of PulseGenerator; expand once, at global scope, in a sketch that lets it use them.
+#define BRIDGE_PULSE_VECTORS \
+	bool bridge::PulseGenerator::Vectors() {return true;} \
+	BRIDGE_PULSE_VECTOR1 \
+	BRIDGE_PULSE_VECTOR3 \
+	BRIDGE_PULSE_VECTOR4 \
+	BRIDGE_PULSE_VECTOR5
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file Quadrature.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Decode the two channels of a quadrature encoder at full (x4) resolution.
+ */
+
+#include <Arduino.h>
+#include "Quadrature.h"
+
+namespace bridge {
+	/* Forward cycle: 00 -> 01 -> 11 -> 10 -> 00.
+	   Index: previous AB state (bits 3-2) and current AB state (bits 1-0).
+	 */
+	const int8_t Quadrature::table[16] = {
+		// 00      01      10      11     (current)
+		    0,     +1,     -1,  error,	// 00 (previous)
+		   -1,      0,  error,     +1,	// 01
+		   +1,  error,      0,     -1,	// 10
+		error,     -1,     +1,      0	// 11
+	};
+	
+	Quadrature::Quadrature(int8_t pinA, int8_t pinB) :
+	portA(BRIDGE_BASEREG(pinA)),
+	portB(BRIDGE_BASEREG(pinB)),
+	maskA(BRIDGE_BITMASK(pinA)),
+	maskB(BRIDGE_BITMASK(pinB)),
+	count(0),
+	errors(0)
+	{
+		// In case the encoder is disconnected, pull-ups will keep a stable state.
+		pinMode(pinA, INPUT_PULLUP);
+		pinMode(pinB, INPUT_PULLUP);
+		state = (BRIDGE_READ(portA, maskA) << 1) | BRIDGE_READ(portB, maskB);
+	}
+	
+	int32_t Quadrature::GetCount() {
+		noInterrupts();
+		int32_t copy = count;
+		interrupts();
+		return copy;
+	}
+	
+	uint16_t Quadrature::GetErrors() {
+		noInterrupts();
+		uint16_t copy = errors;
+		interrupts();
+		return copy;
+	}
+}
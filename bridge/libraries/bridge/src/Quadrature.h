@@ -0,0 +1,70 @@
+/**
+ * @file Quadrature.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Decode the two channels of a quadrature encoder at full (x4) resolution.
+ */
+
+#ifndef BRIDGE_QUADRATURE_H
+#define BRIDGE_QUADRATURE_H
+
+#include <Arduino.h>
+#include "tools.h"
+
+namespace bridge {
+	/**
+	 * @class Quadrature
+	 * @brief Count every edge of both channels of a quadrature encoder and detect missed edges.
+	 * @details Sample reads both channels and looks up the transition from the previous reading in a 16-entry table:
+	 * a change in one channel is a step forward or backward, no change is ignored, and a change in both channels
+	 * means an edge was missed, which is counted as an error. Sample is meant to run from the interrupt service
+	 * routines of both channels (on CHANGE) and takes a few dozen cycles; otherwise it may be polled regularly.
+	 * Channel A rising while channel B is high counts forward, as in x1 decoding of the rising edges of A.
+	 */
+	class Quadrature {
+		public:
+			/// @brief Default constructor.
+			Quadrature() {};
+			
+			/**
+			 * @brief Decode channels in the given pins, which are set as inputs with pull-ups.
+			 * @param[in] pinA GPIO number of channel A.
+			 * @param[in] pinB GPIO number of channel B.
+			 */
+			Quadrature(int8_t pinA, int8_t pinB);
+			
+			/// @brief Read both channels and update the count. Call with interrupts disabled (e.g. from an interrupt service routine).
+			inline void Sample() {
+				uint8_t ab = (BRIDGE_READ(portA, maskA) << 1) | BRIDGE_READ(portB, maskB);
+				int8_t step = table[(state << 2) | ab];
+				state = ab;
+				if (step == error)
+					errors++;
+				else
+					count += step;
+			}
+			
+			/// @return Number of steps counted, forward minus backward.
+			int32_t GetCount();
+			
+			/// @return Number of transitions where both channels changed (i.e. an edge was missed).
+			uint16_t GetErrors();
+			
+		private:
+			static const int8_t error = 2;		///< Marks illegal transitions in the table.
+			static const int8_t table[16];		///< Step for each transition, indexed by previous and current AB states.
+			
+			volatile BRIDGE_IO_REG_TYPE* portA;	///< Hardware address of channel A.
+			volatile BRIDGE_IO_REG_TYPE* portB;	///< Hardware address of channel B.
+			BRIDGE_IO_REG_TYPE maskA;			///< Mask to single out channel A in its hardware address.
+			BRIDGE_IO_REG_TYPE maskB;			///< Mask to single out channel B in its hardware address.
+			
+			volatile uint8_t state;				///< Last AB reading.
+			volatile int32_t count;				///< Steps counted.
+			volatile uint16_t errors;			///< Illegal transitions counted.
+	};
+}
+
+#endif
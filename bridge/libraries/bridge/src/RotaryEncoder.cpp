@@ -9,9 +9,10 @@
 #include "RotaryEncoder.h"
 #include "tools.h"
 #include "meta.h"
+#include "PinChange.h"
 
 namespace bridge {
-	RotaryEncoder::RotaryEncoder(int8_t pin1, int8_t pin2, Function function, FunctionData functionData, int32_t data) :
+	RotaryEncoder::RotaryEncoder(int8_t pin1, int8_t pin2, Resolution resolution, Function function, FunctionData functionData, int32_t data) :
 		// Digital pin numbers, register addresses and pin masks.
 		pin1(pin1),
 		pin2(pin2),
@@ -24,6 +25,8 @@ namespace bridge {
 		mask1(BRIDGE_BITMASK(pin1)),
 		mask2(BRIDGE_BITMASK(pin2)),
 		
+		resolution(resolution),
+		
 		// Value synchronization.
 		asyncValue(0),
 		syncValue(0)
@@ -32,19 +35,45 @@ namespace bridge {
 		pinMode(pin2, INPUT_PULLUP);
 		lastPin1State = BRIDGE_READ(port1, mask1);
 		int interruptId = digitalPinToInterrupt(pin1);
-		if (interruptId >= 0) {
+		if (resolution == Resolution::x4) {
+			decoder = Quadrature(pin1, pin2);
+			// Decode on changes of either pin, using external or pin change interrupts; poll when either is missing.
+			bool attached1 = AttachChange(pin1);
+			bool attached2 = AttachChange(pin2);
+			interruptible = attached1 && attached2;
+		} else if (interruptId >= 0) {
 			interruptible = true;
 			// std is not supported in Arduino and lambda expressions cannot be passed
 			// as arguments to functions when capturing variables. As a solution, map 
 			// from (*void)(void) to (*void)(int) "previously" declared:
 			attachInterrupt(interruptId, meta::Wrap(OnRise, (Data) this), RISING);
 		} else {
-			interruptible = false;
+			interruptible = PinChange::Attach(pin1, OnPinRise, (Data) this);
 		}
 	}
 	
 	RotaryEncoder::~RotaryEncoder() {
-		detachInterrupt(digitalPinToInterrupt(pin1));
+		Detach(pin1);
+		if (resolution == Resolution::x4)
+			Detach(pin2);
+	}
+	
+	bool RotaryEncoder::AttachChange(int8_t pin) {
+		int interruptId = digitalPinToInterrupt(pin);
+		if (interruptId >= 0) {
+			attachInterrupt(interruptId, meta::Wrap(OnChange, (Data) this), CHANGE);
+			return true;
+		} else {
+			return PinChange::Attach(pin, OnPinChange, (Data) this);
+		}
+	}
+	
+	void RotaryEncoder::Detach(int8_t pin) {
+		int interruptId = digitalPinToInterrupt(pin);
+		if (interruptId >= 0)
+			detachInterrupt(interruptId);
+		else
+			PinChange::Detach(pin);
 	}
 	
 	void RotaryEncoder::OnRise(Data data) {
@@ -55,9 +84,30 @@ namespace bridge {
 		asyncValue += BRIDGE_READ(port2, mask2) ? +1 : -1;
 	}
 	
+	void RotaryEncoder::OnPinRise(Data data, bool state) {
+		if (state)
+			((RotaryEncoder*) data)->OnRise();
+	}
+	
+	void RotaryEncoder::OnChange(Data data) {
+		((RotaryEncoder*) data)->decoder.Sample();
+	}
+	
+	void RotaryEncoder::OnPinChange(Data data, bool state) {
+		((RotaryEncoder*) data)->decoder.Sample();
+	}
+	
 	void RotaryEncoder::Step() {
 		int32_t change;
-		if (interruptible) {
+		if (resolution == Resolution::x4) {
+			if (!interruptible) {
+				noInterrupts();
+				decoder.Sample();
+				interrupts();
+			}
+			change = decoder.GetCount() - syncValue;
+			syncValue += change;
+		} else if (interruptible) {
 			noInterrupts();
 			change = asyncValue - syncValue;
 			syncValue = asyncValue;
@@ -92,4 +142,8 @@ namespace bridge {
 	int8_t RotaryEncoder::GetPin2() {
 		return pin2;
 	}
+	
+	uint16_t RotaryEncoder::GetErrors() {
+		return resolution == Resolution::x4 ? decoder.GetErrors() : 0;
+	}
 }
\ No newline at end of file
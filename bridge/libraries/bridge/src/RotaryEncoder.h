@@ -9,6 +9,7 @@
 #define BRIDGE_ROTARYENCODER_H
 
 #include <stdint.h>
+#include "Quadrature.h"
 #include "Stepper.h"
 #include "tools.h"
 
@@ -18,17 +19,22 @@ namespace bridge {
 			typedef uintptr_t Data; 
 			typedef void (*Function) (RotaryEncoder* rotaryEncoder, int32_t change);
 			typedef void (*FunctionData) (RotaryEncoder* rotaryEncoder, int32_t change, Data data);
+			/// Count rising edges of pin1 (x1) or both edges of both pins (x4).
+			enum class Resolution : uint8_t {x1, x4};
 			RotaryEncoder() {};
-			RotaryEncoder(int8_t pin1, int8_t pin2, Function function) : RotaryEncoder(pin1, pin2, function, nullptr, 0) {};
-			RotaryEncoder(int8_t pin1, int8_t pin2, FunctionData functionData, Data data) : RotaryEncoder(pin1, pin2, nullptr, functionData, data) {};
+			RotaryEncoder(int8_t pin1, int8_t pin2, Function function) : RotaryEncoder(pin1, pin2, Resolution::x1, function, nullptr, 0) {};
+			RotaryEncoder(int8_t pin1, int8_t pin2, FunctionData functionData, Data data) : RotaryEncoder(pin1, pin2, Resolution::x1, nullptr, functionData, data) {};
+			RotaryEncoder(int8_t pin1, int8_t pin2, Resolution resolution, Function function) : RotaryEncoder(pin1, pin2, resolution, function, nullptr, 0) {};
+			RotaryEncoder(int8_t pin1, int8_t pin2, Resolution resolution, FunctionData functionData, Data data) : RotaryEncoder(pin1, pin2, resolution, nullptr, functionData, data) {};
 			void Step() override;
 			int8_t GetPin1();
 			int8_t GetPin2();
 			int32_t GetValue();
+			uint16_t GetErrors();			// Number of missed edges detected in x4 resolution.
 			~RotaryEncoder();
 			
 		private:
-			RotaryEncoder(int8_t pin1, int8_t pin2, Function function, FunctionData functionData, int32_t data);
+			RotaryEncoder(int8_t pin1, int8_t pin2, Resolution resolution, Function function, FunctionData functionData, int32_t data);
 			
 			volatile BRIDGE_IO_REG_TYPE* port1;			///< Hardware address of pin1.
 			volatile BRIDGE_IO_REG_TYPE* port2;			///< Hardware address of pin2.
@@ -42,6 +48,13 @@ namespace bridge {
 			int8_t pin2;
 			static void OnRise(Data data);
 			void OnRise();
+			static void OnPinRise(Data data, bool state);
+			static void OnChange(Data data);
+			static void OnPinChange(Data data, bool state);
+			bool AttachChange(int8_t pin);
+			void Detach(int8_t pin);
+			Resolution resolution;
+			Quadrature decoder;				// Decoder used in x4 resolution.
 			bool interruptible;
 			bool lastPin1State;				// Current contact state.
 			int32_t asyncValue;
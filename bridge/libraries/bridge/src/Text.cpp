@@ -0,0 +1,127 @@
+/**
+ * @file Text.cpp
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Format text into a fixed buffer without heap allocations.
+ */
+
+#include <Arduino.h>
+#include "Text.h"
+
+namespace bridge {
+	Text::Text(Print* print) :
+	print(print),
+	length(0)
+	{
+	}
+	
+	Text::~Text() {
+		Flush();
+	}
+	
+	void Text::Flush() {
+		if (length > 0) {
+			print->write((const uint8_t*) buffer, length);
+			length = 0;
+		}
+	}
+	
+	void Text::Append(char character) {
+		if (length == BRIDGE_TEXT_SIZE)
+			Flush();
+		buffer[length++] = character;
+	}
+	
+	void Text::AppendSigned(int32_t value) {
+		if (value < 0) {
+			Append('-');
+			// Negate in unsigned arithmetic so that the most negative value does not overflow.
+			AppendUnsigned(0UL - (uint32_t) value);
+		} else {
+			AppendUnsigned(value);
+		}
+	}
+	
+	void Text::AppendUnsigned(uint32_t value) {
+		// Digits are produced backwards; 32-bit divisions are only used while the value does not fit in 16 bits.
+		char digits[10];
+		uint8_t n = 0;
+		while (value > 0xFFFF) {
+			digits[n++] = '0' + value % 10;
+			value /= 10;
+		}
+		uint16_t small = value;
+		do {
+			digits[n++] = '0' + small % 10;
+			small /= 10;
+		} while (small > 0);
+		while (n > 0)
+			Append(digits[--n]);
+	}
+	
+	Text& Text::operator<<(const __FlashStringHelper* text) {
+		const char* p = reinterpret_cast<const char*>(text);
+		char character;
+		while ((character = pgm_read_byte(p++)))
+			Append(character);
+		return *this;
+	}
+	
+	Text& Text::operator<<(const char* text) {
+		while (*text)
+			Append(*text++);
+		return *this;
+	}
+	
+	Text& Text::operator<<(char character) {
+		Append(character);
+		return *this;
+	}
+	
+	Text& Text::operator<<(bool value) {
+		Append(value ? '1' : '0');
+		return *this;
+	}
+	
+	Text& Text::operator<<(signed char value) {
+		AppendSigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(unsigned char value) {
+		AppendUnsigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(short value) {
+		AppendSigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(unsigned short value) {
+		AppendUnsigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(int value) {
+		AppendSigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(unsigned int value) {
+		AppendUnsigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(long value) {
+		AppendSigned(value);
+		return *this;
+	}
+	
+	Text& Text::operator<<(unsigned long value) {
+		AppendUnsigned(value);
+		return *this;
+	}
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Text.h
+ * @author Leonardo Molina (leonardomt@gmail.com).
+ * @date 2026-10-17
+ * @version 0.1.261017
+ * 
+ * @brief Format text into a fixed buffer without heap allocations.
+ */
+
+#ifndef BRIDGE_TEXT_H
+#define BRIDGE_TEXT_H
+
+#include <Arduino.h>
+
+/// Size of the formatting buffer; longer texts are written in several chunks.
+#define BRIDGE_TEXT_SIZE 64
+
+namespace bridge {
+	/**
+	 * @class Text
+	 * @brief Format text into a fixed buffer and write it to a Print (e.g. Serial) in bulk.
+	 * @details Unlike String, no memory is allocated from the heap. The buffer is written with a single
+	 * call to write(buffer, length) when it fills up, when Flush is called, and when the object is destroyed,
+	 * hence a temporary formats and sends a whole line in one statement:
+	 *     Text(&Serial) << F("pin:") << pin << F(",value:") << value << '\n';
+	 * Keys should be wrapped in F() so that they are read from flash rather than copied into SRAM.
+	 */
+	class Text {
+		public:
+			/**
+			 * @brief Format text for the given output.
+			 * @param[in] print Destination of the formatted text.
+			 */
+			Text(Print* print);
+			
+			/// @brief Write pending text.
+			~Text();
+			
+			Text& operator<<(const __FlashStringHelper* text);
+			Text& operator<<(const char* text);
+			Text& operator<<(char character);
+			Text& operator<<(bool value);
+			Text& operator<<(signed char value);
+			Text& operator<<(unsigned char value);
+			Text& operator<<(short value);
+			Text& operator<<(unsigned short value);
+			Text& operator<<(int value);
+			Text& operator<<(unsigned int value);
+			Text& operator<<(long value);
+			Text& operator<<(unsigned long value);
+			
+			/// @brief Write pending text to the output in one call.
+			void Flush();
+			
+		private:
+			void Append(char character);
+			void AppendSigned(int32_t value);
+			void AppendUnsigned(uint32_t value);
+			
+			Print* print;					///< Destination of the formatted text.
+			uint8_t length;					///< Number of characters in the buffer.
+			char buffer[BRIDGE_TEXT_SIZE];	///< Formatted text pending to be written.
+	};
+}
+
+#endif